@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "append.h"
+
+#include <cerrno>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+
+
+namespace {
+
+    int open_append(const std::string& path, int mode = O_WRONLY)
+    {
+	return open(path.c_str(), mode | O_APPEND | O_CREAT | O_CLOEXEC, 0666);
+    }
+
+    bool same_file(int fd, const std::string& path)
+    {
+	struct stat a;
+	struct stat b;
+	if(fstat(fd, &a) || stat(path.c_str(), &b)) return false;
+	return a.st_dev==b.st_dev && a.st_ino==b.st_ino;
+    }
+
+    /**
+     * A single write(2), unless it's interrupted or the disk fills
+     * up, in which case we do our best to write the rest.
+     */
+    bool write_all(int fd, const char* p, size_t n)
+    {
+	while(n) {
+	    const ssize_t res = write(fd, p, n);
+	    if(res==-1) {
+		if(errno==EINTR) continue;
+		return false;
+	    }
+	    p += res;
+	    n -= res;
+	}
+	return true;
+    }
+}
+
+
+/**
+ * Open 'path' for reading and appending (creating it if needed) and
+ * lock it.
+ * If the file was replaced while we waited for the lock, we're
+ * holding a lock on the old, unlinked one; try again.  Returns the
+ * file descriptor, or -1 with errno set.
+ *
+ * Replacing a file under this lock, like weather_compact(1) and
+ * snapshot() do, is therefore safe.
+ */
+int open_locked(const std::string& path)
+{
+    while(1) {
+	const int fd = open_append(path, O_RDWR);
+	if(fd==-1) return -1;
+	if(flock(fd, LOCK_EX)) {
+	    const int err = errno;
+	    close(fd);
+	    errno = err;
+	    return -1;
+	}
+	if(same_file(fd, path)) return fd;
+	close(fd);
+    }
+}
+
+/**
+ * Append 'buf' to the file 'path', creating it if needed.
+ * Returns success, or failure with errno set.
+ */
+bool Append::operator() (const std::string& path, const std::string& buf) const
+{
+    const int fd = lock ? open_locked(path) : open_append(path);
+    if(fd==-1) return false;
+
+    const bool ok = (*this)(fd, buf);
+
+    const int err = errno;
+    close(fd);
+    errno = err;
+    return ok;
+}
+
+/**
+ * Append 'buf' to the file 'fd', already opened for appending (and
+ * locked, if that's wanted) by the caller.
+ */
+bool Append::operator() (int fd, const std::string& buf) const
+{
+    bool ok = write_all(fd, buf.data(), buf.size());
+    if(ok) {
+	switch(sync) {
+	case Sync::none: break;
+	case Sync::data: ok = !fdatasync(fd); break;
+	case Sync::full: ok = !fsync(fd); break;
+	}
+    }
+    return ok;
+}
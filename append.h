@@ -0,0 +1,66 @@
+/* -*- c++ -*-
+ *
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WEATHER_APPEND_H
+#define WEATHER_APPEND_H
+
+#include <string>
+
+
+/**
+ * Appending to weather(5) files, in a way which is safe even if
+ * there are several writers (overlapping cron jobs), or if
+ * weather_compact(1) is rewriting the file at the same time:
+ *
+ * - The whole buffer goes out in a single write(2) on an O_APPEND
+ *   file descriptor, so records are never interleaved.
+ *
+ * - Optionally under an exclusive flock(2), which is what
+ *   weather_compact(1) uses to catch up with appended data.
+ *
+ * - Optionally followed by fdatasync(2) or fsync(2).
+ */
+class Append {
+public:
+    enum class Sync { none, data, full };
+
+    Append(bool lock, Sync sync)
+	: lock{lock},
+	  sync{sync}
+    {}
+
+    bool operator() (const std::string& path, const std::string& buf) const;
+    bool operator() (int fd, const std::string& buf) const;
+
+private:
+    const bool lock;
+    const Sync sync;
+};
+
+int open_locked(const std::string& path);
+
+#endif
@@ -63,6 +63,35 @@ double Area::yscale(double val) const
     return offset + (scale.max - val) * dim.height / (scale.max - scale.min);
 }
 
+/**
+ * Like xscale(val), for all of [a, b) at once.  Written as a plain
+ * loop over arrays, for the compiler to vectorize.
+ */
+void Area::xscale(const double* a, const double* b, double* out) const
+{
+    const double width = dim.width;
+    const size_t n = b - a;
+    for(size_t i = 0; i < n; i++) {
+	out[i] = width * a[i];
+    }
+}
+
+/**
+ * Like yscale(val), for all of [a, b) at once.  The result is
+ * exactly the same as if you'd done it value by value.
+ */
+void Area::yscale(const Value* a, const Value* b, double* out) const
+{
+    const double off = offset;
+    const int max = scale.max;
+    const unsigned height = dim.height;
+    const int range = scale.max - scale.min;
+    const size_t n = b - a;
+    for(size_t i = 0; i < n; i++) {
+	out[i] = off + (max - a[i].value()) * height / range;
+    }
+}
+
 SubArea::SubArea(const Area& around, const Scale& scale, unsigned height)
     : Area(scale, {around.dim.width, height},
 	   around.offset + around.dim.height - height)
@@ -30,6 +30,8 @@
 
 #include "value.h"
 
+#include <cstddef>
+
 
 struct Dimensions {
     unsigned width;
@@ -72,6 +74,9 @@ public:
     double yscale(double val) const;
     double yscale(Value val) const { return yscale(val.value()); }
 
+    void xscale(const double* a, const double* b, double* out) const;
+    void yscale(const Value* a, const Value* b, double* out) const;
+
     const unsigned offset;
     const Dimensions dim;
     const Scale scale;
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "atomic.h"
+
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+
+namespace {
+
+    /**
+     * The permissions to give the replacement: the same as the
+     * original if there is one.
+     */
+    mode_t mode_of(const std::string& path)
+    {
+	struct stat st;
+	if(stat(path.c_str(), &st)) return 0644;
+	return st.st_mode & 07777;
+    }
+
+    /**
+     * The mkstemp(3) template: dir/.name.XXXXXX, so that a shell
+     * wildcard doesn't pick it up while it's being written.
+     */
+    std::string temp_name(const std::string& path)
+    {
+	const auto n = path.rfind('/');
+	const auto base = n==std::string::npos ? 0 : n+1;
+	return path.substr(0, base) + '.' + path.substr(base) + ".XXXXXX";
+    }
+}
+
+
+AtomicFile::AtomicFile(const std::string& path)
+    : path{path},
+      tmp{temp_name(path)},
+      fd{mkstemp(&tmp[0])},
+      err{fd==-1 ? errno : 0}
+{
+    if(fd==-1) return;
+    fchmod(fd, mode_of(path));
+    fs.open(tmp, std::ios::trunc);
+    if(!fs) {
+	err = errno;
+	close(fd);
+	unlink(tmp.c_str());
+	fd = -1;
+    }
+}
+
+AtomicFile::~AtomicFile()
+{
+    if(fd==-1) return;
+    fs.close();
+    close(fd);
+    unlink(tmp.c_str());
+}
+
+std::string AtomicFile::error() const
+{
+    return std::strerror(err);
+}
+
+/**
+ * Flush the new contents to disk and move them into place.
+ * Returns success.
+ */
+bool AtomicFile::commit()
+{
+    if(fd==-1) return false;
+    fs.close();
+    if(fs.fail()) {
+	err = EIO;
+	return false;
+    }
+    if(fsync(fd) || std::rename(tmp.c_str(), path.c_str())) {
+	err = errno;
+	return false;
+    }
+    close(fd);
+    fd = -1;
+    return true;
+}
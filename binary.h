@@ -0,0 +1,72 @@
+/* -*- c++ -*-
+ *
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WEATHER_BINARY_H
+#define WEATHER_BINARY_H
+
+#include <string>
+#include <iostream>
+#include <cstdint>
+
+/**
+ * Trivial binary serialization of numbers and strings, in the host's
+ * byte order.  For caches, which aren't meant to be moved between
+ * machines.  get() returns false at EOF, or if a string is too long
+ * to be anything but garbage.
+ */
+namespace binary {
+
+    template <class T>
+    void put(std::ostream& os, T val)
+    {
+	os.write(reinterpret_cast<const char*>(&val), sizeof val);
+    }
+
+    inline
+    void put(std::ostream& os, const std::string& s)
+    {
+	put<std::uint64_t>(os, s.size());
+	os.write(s.data(), s.size());
+    }
+
+    template <class T>
+    bool get(std::istream& is, T& val)
+    {
+	return bool(is.read(reinterpret_cast<char*>(&val), sizeof val));
+    }
+
+    inline
+    bool get(std::istream& is, std::string& s)
+    {
+	std::uint64_t n;
+	if(!get(is, n) || n > 1u << 30) return false;
+	s.resize(n);
+	return bool(is.read(&s[0], n));
+    }
+}
+
+#endif
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "cache.h"
+
+#include "mapping.h"
+#include "week.h"
+#include "atomic.h"
+#include "binary.h"
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+
+namespace {
+
+    const std::string magic = "weather curves 1";
+
+    /**
+     * The octets just before 'size' in the file; a few dozen samples,
+     * so enough to tell if a file which has grown has been rewritten
+     * rather than appended to.
+     */
+    std::string guard(const Mapping& map, size_t size)
+    {
+	const size_t n = std::min<size_t>(size, 4096);
+	return {map.begin() + size - n, map.begin() + size};
+    }
+
+    /**
+     * FNV-1a.
+     */
+    std::uint64_t hash(const std::string& s)
+    {
+	std::uint64_t h = 0xcbf29ce484222325;
+	for(unsigned char c : s) {
+	    h ^= c;
+	    h *= 0x100000001b3;
+	}
+	return h;
+    }
+}
+
+
+CurveCache::CurveCache(const std::string& dir)
+    : dir{dir}
+{}
+
+std::string CurveCache::name(const std::string& path, const Week& week) const
+{
+    char buf[17];
+    std::snprintf(buf, sizeof buf, "%016llx",
+		  static_cast<unsigned long long>(hash(path)));
+    return dir + '/' + buf + '-' + week.monday();
+}
+
+/**
+ * Look up the entry for 'path' (mapped as 'map') and 'week'.  If it
+ * covers all of the file, or only its first 'size' octets, the
+ * cached data is returned in 'data'.  A prefix always ends with a
+ * complete line.
+ */
+CurveCache::Found CurveCache::find(const std::string& path, const Week& week,
+				   const Mapping& map,
+				   size_t& size, std::string& data) const
+{
+    std::ifstream is{name(path, week), std::ios::binary};
+    std::string s;
+    if(!binary::get(is, s) || s!=magic) return Found::nothing;
+    if(!binary::get(is, s) || s!=path) return Found::nothing;
+    if(!binary::get(is, s) || s!=week.monday()) return Found::nothing;
+
+    std::uint64_t inode;
+    std::int64_t mtime;
+    std::uint64_t n;
+    std::string g;
+    if(!binary::get(is, inode) ||
+       !binary::get(is, mtime) ||
+       !binary::get(is, n) ||
+       !binary::get(is, g) ||
+       !binary::get(is, data)) return Found::nothing;
+
+    const size_t end = map.end() - map.begin();
+    if(inode != map.inode() || n > end) return Found::nothing;
+    size = n;
+    if(guard(map, size) != g) return Found::nothing;
+
+    if(size==end) {
+	return mtime==map.mtime() ? Found::all : Found::nothing;
+    }
+    if(size && map.begin()[size-1] != '\n') return Found::nothing;
+    return Found::prefix;
+}
+
+/**
+ * Store 'data' as the entry for all of 'path' (mapped as 'map') and
+ * 'week'.  Returns success, printing errors to 'err'.
+ */
+bool CurveCache::store(const std::string& path, const Week& week,
+		       const Mapping& map,
+		       const std::string& data,
+		       std::ostream& err) const
+{
+    const std::string entry = name(path, week);
+    const size_t size = map.end() - map.begin();
+
+    AtomicFile file{entry};
+    if(file) {
+	std::ostream& os = file.os();
+	binary::put(os, magic);
+	binary::put(os, path);
+	binary::put(os, week.monday());
+	binary::put<std::uint64_t>(os, map.inode());
+	binary::put<std::int64_t>(os, map.mtime());
+	binary::put<std::uint64_t>(os, size);
+	binary::put(os, guard(map, size));
+	binary::put(os, data);
+	if(file.commit()) return true;
+    }
+    err << "cannot write '" << entry << "': " << file.error() << '\n';
+    return false;
+}
@@ -0,0 +1,75 @@
+/* -*- c++ -*-
+ *
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WEATHER_CACHE_H
+#define WEATHER_CACHE_H
+
+#include <string>
+#include <iosfwd>
+#include <cstddef>
+
+class Mapping;
+class Week;
+
+/**
+ * An on-disk cache of what Curves parsed from a weather(5) file for
+ * a certain week.  An entry is keyed by the file's path, inode, size
+ * and modification time, and the week.  If the file has only grown
+ * since then, the entry is still good for the prefix it covers, and
+ * only the new tail needs to be parsed.
+ *
+ * The entries are files in a directory of their own, named after a
+ * hash of the path and the week's Monday.  The format is binary and
+ * not portable; anything unexpected in an entry makes it a miss.
+ */
+class CurveCache {
+public:
+    explicit CurveCache(const std::string& dir);
+
+    enum class Found { nothing, all, prefix };
+
+    Found find(const std::string& path, const Week& week,
+	       const Mapping& map,
+	       size_t& size, std::string& data) const;
+    bool store(const std::string& path, const Week& week,
+	       const Mapping& map,
+	       const std::string& data,
+	       std::ostream& err) const;
+
+    struct Stats {
+	unsigned hits = 0;
+	unsigned partial = 0;
+	unsigned misses = 0;
+    };
+    Stats stats;
+
+private:
+    std::string name(const std::string& path, const Week& week) const;
+    const std::string dir;
+};
+
+#endif
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "canvas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <ostream>
+
+#include <zlib.h>
+
+using raster::Canvas;
+using raster::Color;
+using raster::Point;
+using raster::Polygon;
+using raster::Polygons;
+
+
+Canvas::Canvas(unsigned width, unsigned height, Color background)
+    : w{width},
+      h{height},
+      mask(w * h),
+      run(w + 1),
+      run_a{w},
+      run_b{0},
+      dirty_x(h, {w, 0}),
+      dirty_y0{h},
+      dirty_y1{0}
+{
+    rgb.resize(3 * w * h);
+    for(size_t i = 0; i < rgb.size(); i += 3) {
+	rgb[i] = background.r;
+	rgb[i+1] = background.g;
+	rgb[i+2] = background.b;
+    }
+}
+
+Color Canvas::at(unsigned x, unsigned y) const
+{
+    const unsigned char* p = &rgb[3 * (y * w + x)];
+    return {p[0], p[1], p[2]};
+}
+
+namespace {
+
+    /**
+     * Sub-scanlines per row of pixels, when filling.  Horizontally,
+     * coverage is exact.
+     */
+    const unsigned sub = 5;
+
+    /**
+     * A polygon edge, top to bottom, and whether it was drawn
+     * downwards (+1) or upwards (-1).
+     */
+    struct Edge {
+	double x0;
+	double y0;
+	double x1;
+	double y1;
+	int dir;
+
+	double x(double y) const { return x0 + (y - y0) * (x1 - x0) / (y1 - y0); }
+    };
+
+    bool by_top(const Edge& a, const Edge& b)
+    {
+	return a.y0 < b.y0;
+    }
+
+    struct Crossing {
+	double x;
+	int dir;
+
+	bool operator< (const Crossing& other) const { return x < other.x; }
+    };
+}
+
+/**
+ * Cover the inside of the polygons, by the non-zero winding rule.
+ * They don't have to be closed; the last point connects to the
+ * first.
+ */
+void Canvas::fill(const Polygons& v)
+{
+    std::vector<Edge> edges;
+    double left = w;
+    double right = 0;
+    double top = h;
+    double bottom = 0;
+    for(const Polygon& p : v) {
+	const size_t n = p.size();
+	for(size_t i = 0; i < n; i++) {
+	    Point a = p[i];
+	    Point b = p[(i + 1) % n];
+	    if(a.second==b.second) continue;
+	    int dir = 1;
+	    if(b.second < a.second) {
+		std::swap(a, b);
+		dir = -1;
+	    }
+	    edges.push_back({a.first, a.second, b.first, b.second, dir});
+	    left = std::min({left, a.first, b.first});
+	    right = std::max({right, a.first, b.first});
+	    top = std::min(top, a.second);
+	    bottom = std::max(bottom, b.second);
+	}
+    }
+    top = std::max(top, 0.0);
+    bottom = std::min(bottom, double(h));
+    if(edges.empty() || top >= bottom) return;
+    dirty(left, top, right, bottom);
+
+    std::sort(begin(edges), end(edges), by_top);
+    auto next = begin(edges);
+    std::vector<const Edge*> active;
+    std::vector<Crossing> xs;
+
+    for(unsigned j = top; j < bottom; j++) {
+	float* const row = &mask[j * w];
+	for(unsigned k = 0; k < sub; k++) {
+	    const double y = j + (k + .5) / sub;
+	    while(next!=end(edges) && next->y0 <= y) active.push_back(&*next++);
+
+	    xs.clear();
+	    size_t n = 0;
+	    for(const Edge* e : active) {
+		if(e->y1 <= y) continue;
+		active[n++] = e;
+		xs.push_back({e->x(y), e->dir});
+	    }
+	    active.resize(n);
+	    std::sort(begin(xs), end(xs));
+
+	    int winding = 0;
+	    double start = 0;
+	    for(const Crossing& c : xs) {
+		const int prev = winding;
+		winding += c.dir;
+		if(!prev) start = c.x;
+		else if(!winding) span(row, start, c.x, 1.0 / sub);
+	    }
+	}
+
+	float cover = 0;
+	for(unsigned i = run_a; i < run_b; i++) {
+	    cover += run[i];
+	    run[i] = 0;
+	    row[i] += cover;
+	}
+	run[run_b] = 0;
+	run_a = w;
+	run_b = 0;
+    }
+}
+
+/**
+ * Cover a row of pixels from x = a to b, by 'cover'.  The pixels
+ * which are covered in full are only noted in 'run', as where the
+ * cover starts and ends, since fill() usually covers them several
+ * times over before it sums them up.
+ */
+void Canvas::span(float* row, double a, double b, double cover)
+{
+    a = std::max(a, 0.0);
+    b = std::min(b, double(w));
+    if(a >= b) return;
+
+    const unsigned ia = a;
+    const unsigned ib = b;
+    if(ia==ib) {
+	row[ia] += (b - a) * cover;
+	return;
+    }
+    row[ia] += (ia + 1 - a) * cover;
+    run[ia + 1] += cover;
+    run[ib] -= cover;
+    run_a = std::min(run_a, ia + 1);
+    run_b = std::max(run_b, ib);
+    if(ib < w) row[ib] += (b - ib) * cover;
+}
+
+/**
+ * Cover the polylines, drawn with a certain width, with round
+ * joins and ends.  Lines thinner than a pixel are drawn a pixel
+ * wide, but fainter.
+ */
+void Canvas::stroke(const Polygons& v, double width)
+{
+    const double r = std::max(width / 2, .5);
+    const double k = std::min(width, 1.0);
+    for(const Polygon& p : v) {
+	if(p.size()==1) segment(p[0], p[0], r, k);
+	for(size_t i = 1; i < p.size(); i++) segment(p[i-1], p[i], r, k);
+    }
+}
+
+/**
+ * Cover the pixels whose centers are within 'r' of the line segment
+ * a--b, by 'k', with a pixel's worth of anti-aliasing at the edge.
+ */
+void Canvas::segment(const Point& a, const Point& b, double r, double k)
+{
+    const double x0 = std::max(std::floor(std::min(a.first, b.first) - r), 0.0);
+    const double x1 = std::min(std::ceil(std::max(a.first, b.first) + r), double(w));
+    const double y0 = std::max(std::floor(std::min(a.second, b.second) - r), 0.0);
+    const double y1 = std::min(std::ceil(std::max(a.second, b.second) + r), double(h));
+    if(x0 >= x1 || y0 >= y1) return;
+    dirty(x0, y0, x1, y1);
+
+    const double dx = b.first - a.first;
+    const double dy = b.second - a.second;
+    const double len2 = dx*dx + dy*dy;
+    for(unsigned j = y0; j < y1; j++) {
+	float* const row = &mask[j * w];
+	for(unsigned i = x0; i < x1; i++) {
+	    const double px = i + .5 - a.first;
+	    const double py = j + .5 - a.second;
+	    double t = len2 ? (px*dx + py*dy) / len2 : 0;
+	    t = std::min(std::max(t, 0.0), 1.0);
+	    const double ex = px - t * dx;
+	    const double ey = py - t * dy;
+	    const double d2 = ex*ex + ey*ey;
+	    if(d2 >= (r + .5) * (r + .5)) continue;
+	    const double c = std::min(r + .5 - std::sqrt(d2), 1.0) * k;
+	    if(row[i] < c) row[i] = c;
+	}
+    }
+}
+
+/**
+ * Note that the rectangle may have been covered, so that paint()
+ * only needs to look there: per row, from the leftmost to the
+ * rightmost pixel covered.
+ */
+void Canvas::dirty(double x0, double y0, double x1, double y1)
+{
+    const unsigned a = std::max(std::floor(x0), 0.0);
+    const unsigned b = std::min(std::ceil(x1), double(w));
+    const unsigned top = std::max(std::floor(y0), 0.0);
+    const unsigned bottom = std::min(std::ceil(y1), double(h));
+    for(unsigned j = top; j < bottom; j++) {
+	auto& d = dirty_x[j];
+	d.first = std::min(d.first, a);
+	d.second = std::max(d.second, b);
+    }
+    dirty_y0 = std::min(dirty_y0, top);
+    dirty_y1 = std::max(dirty_y1, bottom);
+}
+
+namespace {
+
+    unsigned char blend(unsigned char a, unsigned char b, double alpha)
+    {
+	return std::lround(a + (b - a) * alpha);
+    }
+}
+
+/**
+ * Paint what's covered since the last paint(), in a color and with
+ * an opacity, 0--1.
+ */
+void Canvas::paint(Color c, double opacity)
+{
+    for(unsigned j = dirty_y0; j < dirty_y1; j++) {
+	auto& d = dirty_x[j];
+	for(unsigned i = d.first; i < d.second; i++) {
+	    float& m = mask[j * w + i];
+	    if(!m) continue;
+	    const double alpha = std::min(m, 1.0f) * opacity;
+	    m = 0;
+	    unsigned char* const p = &rgb[3 * (j * w + i)];
+	    p[0] = blend(p[0], c.r, alpha);
+	    p[1] = blend(p[1], c.g, alpha);
+	    p[2] = blend(p[2], c.b, alpha);
+	}
+	d = {w, 0};
+    }
+    dirty_y0 = h;
+    dirty_y1 = 0;
+}
+
+namespace {
+
+    void put32(std::string& s, unsigned long n)
+    {
+	s += char(n >> 24);
+	s += char(n >> 16);
+	s += char(n >> 8);
+	s += char(n);
+    }
+
+    Bytef* bytes(std::string& s) { return reinterpret_cast<Bytef*>(&s[0]); }
+
+    /**
+     * Append a PNG chunk: length, type, data and the CRC of the
+     * type and data.
+     */
+    void chunk(std::string& s, const char* type, const std::string& data)
+    {
+	put32(s, data.size());
+	const size_t n = s.size();
+	s.append(type, 4);
+	s += data;
+	put32(s, crc32(crc32(0, nullptr, 0), bytes(s) + n, s.size() - n));
+    }
+}
+
+/**
+ * Write the image as PNG (8-bit RGB, no interlacing) to 'os',
+ * deflated at a zlib compression level.  Returns false if that
+ * failed.
+ */
+bool Canvas::png(std::ostream& os, int level) const
+{
+    std::string raw;
+    raw.reserve(h * (1 + 3 * w));
+    for(unsigned j = 0; j < h; j++) {
+	raw += '\0';
+	raw.append(reinterpret_cast<const char*>(&rgb[3 * j * w]), 3 * w);
+    }
+
+    std::string idat(compressBound(raw.size()), '\0');
+    uLongf n = idat.size();
+    if(compress2(bytes(idat), &n, bytes(raw), raw.size(), level)!=Z_OK) return false;
+    idat.resize(n);
+
+    std::string ihdr;
+    put32(ihdr, w);
+    put32(ihdr, h);
+    ihdr.append("\x08\x02\x00\x00\x00", 5);
+
+    std::string s {"\x89PNG\r\n\x1a\n"};
+    chunk(s, "IHDR", ihdr);
+    chunk(s, "IDAT", idat);
+    chunk(s, "IEND", "");
+    return bool(os.write(s.data(), s.size()));
+}
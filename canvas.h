@@ -0,0 +1,91 @@
+/* -*- c++ -*-
+ *
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WEATHER_CANVAS_H
+#define WEATHER_CANVAS_H
+
+#include <vector>
+#include <utility>
+#include <iosfwd>
+
+
+namespace raster {
+
+    struct Color {
+	unsigned char r;
+	unsigned char g;
+	unsigned char b;
+    };
+
+    using Point = std::pair<double, double>;
+    using Polygon = std::vector<Point>;
+    using Polygons = std::vector<Polygon>;
+
+    /**
+     * An RGB image, which shapes are drawn on in two steps: first
+     * fill() and stroke() cover parts of it, and then paint() paints
+     * what's covered in a color, anti-aliased.  Thus the shapes which
+     * make up an SVG element are painted together, and an
+     * overlapping part isn't made darker than the rest.
+     *
+     * Coordinates are in pixels, with (0, 0) the top left corner of
+     * the top left pixel.
+     */
+    class Canvas {
+    public:
+	Canvas() : Canvas{0, 0, {0, 0, 0}} {}
+	Canvas(unsigned width, unsigned height, Color background);
+
+	unsigned width() const { return w; }
+	unsigned height() const { return h; }
+	Color at(unsigned x, unsigned y) const;
+
+	void fill(const Polygons& v);
+	void stroke(const Polygons& v, double width);
+	void paint(Color c, double opacity);
+
+	bool png(std::ostream& os, int level = 6) const;
+
+    private:
+	void span(float* row, double a, double b, double cover);
+	void segment(const Point& a, const Point& b, double r, double k);
+	void dirty(double x0, double y0, double x1, double y1);
+
+	unsigned w;
+	unsigned h;
+	std::vector<unsigned char> rgb;
+	std::vector<float> mask;
+	std::vector<float> run;
+	unsigned run_a;
+	unsigned run_b;
+	std::vector<std::pair<unsigned, unsigned>> dirty_x;
+	unsigned dirty_y0;
+	unsigned dirty_y1;
+    };
+}
+
+#endif
@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "compact.h"
+
+#include "field.h"
+#include "timestamp.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <queue>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <cstdlib>
+
+#include <unistd.h>
+
+
+using compact::Record;
+using compact::Reader;
+
+namespace {
+
+    bool is_comment(const std::string& s)
+    {
+	const char* a = field::ws(s.data(), s.data() + s.size());
+	return a != s.data() + s.size() && *a=='#';
+    }
+
+    bool is_date(const field::Field& f)
+    {
+	return field::is(f, "date");
+    }
+
+    /**
+     * Given two Records with the same date, prefer the one with the
+     * most fields; else the first one.
+     */
+    bool better(const Record& a, const Record& b)
+    {
+	return b.fields > a.fields;
+    }
+
+    const std::time_t unparsed = std::numeric_limits<std::time_t>::max();
+
+    /**
+     * Records in time order, and those with unparsable dates last,
+     * in text order.
+     */
+    bool by_date(const Record& a, const Record& b)
+    {
+	if(a.epoch!=b.epoch) return a.epoch < b.epoch;
+	return a.epoch==unparsed && a.date < b.date;
+    }
+
+    bool same_date(const Record& a, const Record& b)
+    {
+	return !by_date(a, b) && !by_date(b, a);
+    }
+
+    /**
+     * Sort a run of Records, and merge the duplicates in it.
+     */
+    void sort(std::vector<Record>& v, compact::Stats& stats)
+    {
+	std::stable_sort(begin(v), end(v), by_date);
+
+	auto out = begin(v);
+	auto a = begin(v);
+	while(a!=end(v)) {
+	    auto best = a;
+	    auto b = std::next(a);
+	    while(b!=end(v) && same_date(*b, *a)) {
+		if(better(*best, *b)) best = b;
+		stats.duplicates++;
+		b++;
+	    }
+	    if(out!=best) *out = std::move(*best);
+	    out++;
+	    a = b;
+	}
+	v.erase(out, end(v));
+    }
+
+    /**
+     * The output, with samples separated by blank lines like
+     * weather(1) writes them.
+     */
+    class Writer {
+    public:
+	Writer(std::ostream& os, const std::string& header)
+	    : os(os),
+	      delimiter(header.empty() ? "" : "\n")
+	{
+	    os << header;
+	}
+
+	void put(const Record& rec)
+	{
+	    os << delimiter << rec.text;
+	    delimiter = "\n";
+	}
+
+    private:
+	std::ostream& os;
+	const char* delimiter;
+    };
+
+    /**
+     * A sorted run, spilled to an anonymous temporary file and
+     * later read back as part of the merge.
+     */
+    class Run {
+    public:
+	explicit Run(const std::string& tmpdir)
+	    : reader{fs}
+	{
+	    std::string name = tmpdir + "/.weather_compact.XXXXXX";
+	    int fd = mkstemp(&name[0]);
+	    if(fd==-1) return;
+	    fs.open(name, std::ios::in | std::ios::out | std::ios::trunc);
+	    unlink(name.c_str());
+	    close(fd);
+	}
+
+	explicit operator bool () const { return fs.is_open() && fs.good(); }
+
+	void put(const Record& rec) { fs << rec.text; }
+	bool rewind()
+	{
+	    fs.flush();
+	    fs.seekg(0);
+	    return next();
+	}
+	bool next() { return reader.get(rec); }
+
+	Record rec;
+
+    private:
+	std::fstream fs;
+	Reader reader;
+    };
+
+    using Runs = std::vector<std::unique_ptr<Run>>;
+
+    bool spill(Runs& runs, std::vector<Record>& v,
+	       const std::string& tmpdir,
+	       compact::Stats& stats)
+    {
+	sort(v, stats);
+	std::unique_ptr<Run> run {new Run{tmpdir}};
+	if(!*run) return false;
+	for(const auto& rec : v) run->put(rec);
+	if(!*run) return false;
+	v.clear();
+	runs.push_back(std::move(run));
+	stats.runs++;
+	return true;
+    }
+
+    /**
+     * Merge the sorted runs to 'w'.  When the same time appears in
+     * more than one run, pick the best one, and the earliest run if
+     * they're equally good.
+     */
+    void merge(Runs& runs, Writer& w, compact::Stats& stats)
+    {
+	auto later = [&runs] (size_t a, size_t b) {
+			 const auto& ra = runs[a]->rec;
+			 const auto& rb = runs[b]->rec;
+			 if(!same_date(ra, rb)) return by_date(rb, ra);
+			 return b < a;
+		     };
+	std::priority_queue<size_t,
+			    std::vector<size_t>,
+			    decltype(later)> queue {later};
+
+	for(size_t i=0; i<runs.size(); i++) {
+	    if(runs[i]->rewind()) queue.push(i);
+	}
+
+	Record best;
+	while(!queue.empty()) {
+	    size_t i = queue.top();
+	    queue.pop();
+	    best = std::move(runs[i]->rec);
+	    if(runs[i]->next()) queue.push(i);
+
+	    while(!queue.empty() && same_date(runs[queue.top()]->rec, best)) {
+		size_t j = queue.top();
+		queue.pop();
+		if(better(best, runs[j]->rec)) best = std::move(runs[j]->rec);
+		stats.duplicates++;
+		if(runs[j]->next()) queue.push(j);
+	    }
+	    w.put(best);
+	}
+    }
+}
+
+
+Reader::Reader(std::istream& is)
+    : is(is),
+      pending(false)
+{}
+
+/**
+ * Read the next Record. Returns false at end of input.
+ */
+bool Reader::get(Record& rec)
+{
+    field::Field f;
+
+    while(!pending && std::getline(is, line)) {
+	auto kind = field::split(f, line.data(), line.data() + line.size());
+	if(kind==field::Kind::field && is_date(f)) {
+	    pending = true;
+	}
+	else if(kind!=field::Kind::nothing || is_comment(line)) {
+	    head += line;
+	    head += '\n';
+	}
+    }
+    if(!pending) return false;
+
+    field::split(f, line.data(), line.data() + line.size());
+    rec.date.assign(f.val, f.val_end);
+    if(!timestamp::parse(rec.date, rec.epoch)) rec.epoch = unparsed;
+    rec.fields = 0;
+    rec.text = line;
+    rec.text += '\n';
+    pending = false;
+
+    while(std::getline(is, line)) {
+	auto kind = field::split(f, line.data(), line.data() + line.size());
+	if(kind==field::Kind::field) {
+	    if(is_date(f)) {
+		pending = true;
+		break;
+	    }
+	    rec.fields++;
+	}
+	else if(kind==field::Kind::nothing && !is_comment(line)) {
+	    continue;
+	}
+	rec.text += line;
+	rec.text += '\n';
+    }
+    return true;
+}
+
+/**
+ * Read weather(5) data from 'is', and write it sorted and without
+ * duplicates to 'os'.  Comments and malformed lines are kept, either
+ * as a header (if they precede the first sample) or as part of the
+ * sample they appear in.
+ *
+ * Returns false if the temporary files couldn't be written, with
+ * errno set.
+ */
+bool compact::compact(std::istream& is, std::ostream& os,
+		      size_t budget, const std::string& tmpdir,
+		      Stats& stats)
+{
+    Reader reader{is};
+    std::vector<Record> v;
+    Runs runs;
+    size_t size = 0;
+    Record prev;
+
+    Record rec;
+    while(reader.get(rec)) {
+	if(stats.records++ && by_date(rec, prev)) stats.disorder++;
+	prev.date = rec.date;
+	prev.epoch = rec.epoch;
+
+	size += sizeof rec + rec.date.size() + rec.text.size();
+	v.push_back(std::move(rec));
+	if(size > budget) {
+	    if(!spill(runs, v, tmpdir, stats)) return false;
+	    size = 0;
+	}
+    }
+
+    Writer w{os, reader.header()};
+
+    if(runs.empty()) {
+	sort(v, stats);
+	for(const auto& rec : v) w.put(rec);
+	return true;
+    }
+
+    if(v.size() && !spill(runs, v, tmpdir, stats)) return false;
+    merge(runs, w, stats);
+    return true;
+}
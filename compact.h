@@ -0,0 +1,93 @@
+/* -*- c++ -*-
+ *
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WEATHER_COMPACT_H
+#define WEATHER_COMPACT_H
+
+#include <string>
+#include <iosfwd>
+#include <ctime>
+
+/**
+ * Compacting weather(5) data: sorting the samples by time, and
+ * merging duplicates.  Duplicates appear when the same sample has
+ * been downloaded twice; when that happens the sample with the most
+ * fields is kept.
+ *
+ * Time is as parsed by timestamp::parse(), so the hour repeated when
+ * summer time ends is sorted correctly, and two spellings of the same
+ * instant are duplicates.  Samples with dates which cannot be parsed
+ * come last, sorted as text.
+ *
+ * Works with bounded memory: if the input is larger than 'budget'
+ * bytes, it's sorted in runs which are stored in temporary files in
+ * 'tmpdir', and finally merged.
+ */
+namespace compact {
+
+    /**
+     * A sample as text: the date field and the lines following it,
+     * minus blank lines.  The epoch is the parsed date, or the largest
+     * time_t if it cannot be parsed.
+     */
+    struct Record {
+	std::string date;
+	std::time_t epoch;
+	unsigned fields;
+	std::string text;
+    };
+
+    /**
+     * Reading Records from a stream.  Lines before the first date
+     * field form the header().
+     */
+    class Reader {
+    public:
+	explicit Reader(std::istream& is);
+	bool get(Record& rec);
+	const std::string& header() const { return head; }
+
+    private:
+	std::istream& is;
+	std::string line;
+	bool pending;
+	std::string head;
+    };
+
+    struct Stats {
+	unsigned records = 0;
+	unsigned duplicates = 0;
+	unsigned disorder = 0;
+	unsigned runs = 0;
+    };
+
+    bool compact(std::istream& is, std::ostream& os,
+		 size_t budget, const std::string& tmpdir,
+		 Stats& stats);
+}
+
+#endif
@@ -28,120 +28,623 @@
 
 #include "files...h"
 #include "week.h"
+#include "field.h"
+#include "timestamp.h"
+#include "tail.h"
+#include "mapping.h"
+#include "cache.h"
+#include "binary.h"
 
 #include <iostream>
-#include <cctype>
+#include <sstream>
 #include <cstdlib>
 #include <algorithm>
+#include <iterator>
+#include <atomic>
+#include <thread>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
 
 
+/**
+ * Read the samples for 'week'.  In files which can be mapped, we skip
+ * everything before the last 1000 samples (about a week's worth) in
+ * a row which are older than the week.  Malformed lines are only
+ * reported to 'err' in the part which is read.
+ */
+Curves::Curves(const Week& week, Files& files, std::ostream& err)
+{
+    read(week, files, err);
+    finish();
+}
+
 namespace {
 
-    inline bool isspace(char ch)
-    {
-	return std::isspace(static_cast<unsigned char>(ch));
-    }
+    enum class Key { other, date, temperature_air, rain_amount,
+		     wind_force, wind_force_max, wind_direction };
 
     /**
-     * Trim whitespace to the left in [a, b).
+     * Classify a field by name, without building a string.  The
+     * length of the name, and in one case a character, pick the only
+     * possible candidate; then we compare against that one.
      */
-    inline
-    const char* ws(const char* a, const char* b)
+    Key key(const field::Field& f)
     {
-	while(a!=b && isspace(*a)) a++;
-	return a;
+	auto is = [&f] (Key k, const char* s) {
+		      return std::equal(f.name, f.name_end, s) ? k : Key::other;
+		  };
+	switch(f.name_end - f.name) {
+	case 4:  return is(Key::date, "date");
+	case 10: return is(Key::wind_force, "wind.force");
+	case 11: return is(Key::rain_amount, "rain.amount");
+	case 14:
+	    if(f.name[5]=='f') return is(Key::wind_force_max, "wind.force.max");
+	    return is(Key::wind_direction, "wind.direction");
+	case 15: return is(Key::temperature_air, "temperature.air");
+	}
+	return Key::other;
     }
 
     /**
-     * Trim non-whitespace to the left in [a, b).
+     * The first line at or after p (which is in [a, b)) which is a
+     * date: line, or b if there is none.
      */
-    inline
-    const char* non_ws(const char* a, const char* b)
+    const char* resync(const char* a, const char* p, const char* b)
     {
-	while(a!=b && !isspace(*a)) a++;
-	return a;
+	if(p!=a && p[-1]!='\n') {
+	    p = static_cast<const char*>(std::memchr(p, '\n', b - p));
+	    if(!p) return b;
+	    p++;
+	}
+	while(p!=b) {
+	    auto nl = static_cast<const char*>(std::memchr(p, '\n', b - p));
+	    const char* const e = nl ? nl : b;
+	    field::Field f;
+	    if(field::split(f, p, e)==field::Kind::field && field::is(f, "date")) {
+		return p;
+	    }
+	    p = nl ? nl + 1 : b;
+	}
+	return b;
     }
 
     /**
-     * Trim whitespace to the right in [a, b), so that
-     * it's either empty or ends with non-whitespace.
+     * Split [a, b) into at most n chunks of roughly equal size, each
+     * except the first starting with a date: line.  Returns the chunk
+     * boundaries, including a and b.
      */
-    inline
-    const char* trimr(const char* a, const char* b)
+    std::vector<const char*> split(const char* a, const char* b, unsigned n)
     {
-	while(a!=b && isspace(*(b-1))) b--;
-	return b;
+	std::vector<const char*> v {a};
+	const size_t size = (b - a) / n;
+	for(unsigned i = 1; i < n; i++) {
+	    const char* p = resync(a, std::max(a + i*size, v.back()), b);
+	    if(p!=v.back() && p!=b) v.push_back(p);
+	}
+	v.push_back(b);
+	return v;
     }
+
+    /**
+     * A file to read, or the mapped part [a, b) of it.
+     */
+    struct Task {
+	unsigned file;
+	bool mapped;
+	const char* a;
+	const char* b;
+    };
 }
 
 
-Curves::Curves(const Week& week, Files& files, std::ostream& err)
+/**
+ * Like Curves(week, Files{files}, err), but with the files read by
+ * 'jobs' threads.  Files larger than 'chunk' octets (after skipping
+ * what's too old for the week) are also split into chunks, at date:
+ * lines, and read in parallel.  The result, including any error
+ * messages, is the same.
+ */
+Curves::Curves(const Week& week, const std::vector<std::string>& files,
+	       unsigned jobs, std::ostream& err,
+	       size_t chunk)
 {
-    Sample* cur = nullptr;
+    read(week, files, jobs, nullptr, err, chunk);
+    finish();
+}
 
-    auto add = [&cur, &week, this] (const char* a, const char* b) -> Sample* {
-		   const std::string ts{a, b};
-		   double t = week.scale(ts);
-		   bool in_range = 0 <= t && t <= 1;
-		   if(!in_range) return nullptr;
-
-		   if(!cur) {
-		       val.push_back({});
-		   }
-		   auto& v = val.back();
-		   v.emplace_back(t);
-		   return &v.back();
-	       };
-
-    std::string s;
-    while(files.getline(s)) {
-	/* "   foo   :   bar  "
-	 *     a  d  c   e  b
-	 */
-	const char* a = s.data();
-	const char* b = a + s.size();
-	a = ws(a, b);
-	b = trimr(a, b);
-	if(a==b || *a=='#') continue;
-	const char* const c = std::find(a, b, ':');
-	if(c==b) {
-	    err << files.position() << ": malformed line \"" << s << "\"\n";
-	    continue;
-	}
-	const char* const d = trimr(a, c);
-	const char* const e = ws(c+1, b);
-	if(a==d || e==b) {
-	    err << files.position() << ": malformed line \"" << s << "\"\n";
+/**
+ * As above, but with what's parsed from each file kept in 'cache'.
+ * A file which is unchanged since last time isn't read at all, and
+ * one which has grown only has its new tail read.
+ */
+Curves::Curves(const Week& week, const std::vector<std::string>& files,
+	       unsigned jobs, CurveCache& cache, std::ostream& err,
+	       size_t chunk)
+{
+    read(week, files, std::max(jobs, 1u), &cache, err, chunk);
+    finish();
+}
+
+void Curves::read(const Week& week, const std::vector<std::string>& files,
+		  unsigned jobs, CurveCache* cache, std::ostream& err,
+		  size_t chunk)
+{
+    if(!cache && (jobs < 2 || files.empty())) {
+	Files ff{files.begin(), files.end()};
+	read(week, ff, err);
+	return;
+    }
+
+    /* Per file, what the cache provides (perhaps nothing) and if we
+     * should update it afterwards.
+     */
+    struct Cached {
+	Curves part;
+	std::string err;
+	bool store = false;
+    };
+
+    std::vector<Mapping> maps(files.size());
+    std::vector<Cached> cached(files.size());
+    std::vector<Task> tasks;
+    for(unsigned n = 0; n < files.size(); n++) {
+	Mapping& map = maps[n];
+	if(files[n]!="-") map = Mapping{files[n]};
+	if(!map.mapped()) {
+	    tasks.push_back({n, false, nullptr, nullptr});
 	    continue;
 	}
 
-	const std::string key{a, d};
-	if(key=="date") {
-	    cur = add(e, b);
+	const char* a = nullptr;
+	if(cache) {
+	    size_t size;
+	    std::string data;
+	    auto found = cache->find(files[n], week, map, size, data);
+	    if(found != CurveCache::Found::nothing) {
+		std::istringstream is{data};
+		Curves& part = cached[n].part;
+		if(!binary::get(is, cached[n].err) || !part.load(is)) {
+		    part = Curves{};
+		    cached[n].err.clear();
+		    found = CurveCache::Found::nothing;
+		}
+	    }
+	    switch(found) {
+	    case CurveCache::Found::all:
+		cache->stats.hits++;
+		continue;
+	    case CurveCache::Found::prefix:
+		cache->stats.partial++;
+		a = map.begin() + size;
+		break;
+	    case CurveCache::Found::nothing:
+		cache->stats.misses++;
+		break;
+	    }
+	    cached[n].store = true;
 	}
-	else if(!cur) {
-	    continue;
+
+	if(!a) a = tail(map.begin(), map.end(), week, 1000);
+	const size_t size = map.end() - a;
+	const unsigned pieces = std::min<size_t>(jobs, 1 + size / chunk);
+	const auto v = split(a, map.end(), pieces);
+	for(unsigned i = 1; i < v.size(); i++) {
+	    tasks.push_back({n, true, v[i-1], v[i]});
 	}
-	else if(key=="temperature.air") {
-	    cur->temperature_air = {e, b};
+    }
+
+    std::vector<Curves> parts(tasks.size());
+    std::vector<std::ostringstream> errs(tasks.size());
+    std::atomic<unsigned> next{0};
+
+    auto work = [&] {
+		    unsigned n;
+		    while((n = next++) < tasks.size()) {
+			const Task& task = tasks[n];
+			const std::string& name = files[task.file];
+			if(task.mapped) {
+			    Files ff{name, maps[task.file].begin(), task.a, task.b};
+			    parts[n].read(week, ff, errs[n]);
+			}
+			else {
+			    Files ff{&name, &name + 1};
+			    parts[n].read(week, ff, errs[n]);
+			}
+		    }
+		};
+
+    std::vector<std::thread> pool;
+    while(pool.size() < jobs && pool.size() < tasks.size()) pool.emplace_back(work);
+    for(auto& thread : pool) thread.join();
+
+    auto task = tasks.begin();
+    for(unsigned n = 0; n < files.size(); n++) {
+	Cached& file = cached[n];
+	for(; task!=tasks.end() && task->file==n; task++) {
+	    const auto i = task - tasks.begin();
+	    file.part.append(std::move(parts[i]));
+	    file.err += errs[i].str();
 	}
-	else if(key=="rain.amount") {
-	    cur->rain_amount = {e, b};
+	if(file.store) {
+	    std::ostringstream os;
+	    binary::put(os, file.err);
+	    file.part.save(os);
+	    cache->store(files[n], week, maps[n], os.str(), err);
 	}
-	else if(key=="wind.force") {
-	    cur->wind_force = {e, b};
+	append(std::move(file.part));
+	err << file.err;
+    }
+}
+
+namespace {
+
+    /**
+     * Read the fields of 'files', calling date(t) for each date: line
+     * (with a null t if it's unparsable) and field(sel, a, b) for
+     * each field we plot.  Malformed lines are reported to 'err'.
+     */
+    template <class Date, class Field>
+    void scan(Files& files, std::ostream& err, Date date, Field field)
+    {
+	const char* a;
+	const char* b;
+	while(files.getline(a, b)) {
+	    field::Field f;
+	    switch(field::split(f, a, b)) {
+	    case field::Kind::nothing:
+		continue;
+	    case field::Kind::malformed:
+		err << files.position() << ": malformed line \""
+		    << std::string{a, b} << "\"\n";
+		continue;
+	    case field::Kind::field:
+		break;
+	    }
+	    const char* const e = f.val;
+	    const char* const b = f.val_end;
+
+	    Curves::Selection sel;
+	    switch(key(f)) {
+	    case Key::date:
+		std::time_t t;
+		date(timestamp::parse(e, b, t) ? &t : nullptr);
+		continue;
+	    case Key::temperature_air:
+		sel = &Curves::Sample::temperature_air;
+		break;
+	    case Key::rain_amount:
+		sel = &Curves::Sample::rain_amount;
+		break;
+	    case Key::wind_force:
+		sel = &Curves::Sample::wind_force;
+		break;
+	    case Key::wind_force_max:
+		sel = &Curves::Sample::wind_force_max;
+		break;
+	    case Key::wind_direction:
+		sel = &Curves::Sample::wind_direction;
+		break;
+	    case Key::other:
+	    default:
+		continue;
+	    }
+	    field(sel, e, b);
 	}
-	else if(key=="wind.force.max") {
-	    cur->wind_force_max = {e, b};
+    }
+}
+
+/**
+ * Where fields go while reading the curves for a week: to the head
+ * before the first date, to the current sample if it's in the week,
+ * or nowhere.
+ */
+class Curves::Reader {
+public:
+    Reader(Curves& curves, const Week& week)
+	: curves(curves),
+	  week(week)
+    {}
+
+    bool live() const { return at_head || cur; }
+    void date(std::time_t t);
+    void lost();
+    void field(Selection sel, Value val);
+    void end() { curves.ended_open = cur; }
+
+private:
+    Curves& curves;
+    const Week& week;
+    bool at_head = true;
+    Sample* cur = nullptr;
+};
+
+void Curves::Reader::date(std::time_t t)
+{
+    if(!week.contains(t)) return lost();
+
+    curves.dated = true;
+    if(at_head) {
+	curves.started_open = true;
+	at_head = false;
+    }
+    auto& raw = curves.raw;
+    if(!cur) raw.push_back({});
+    auto& v = raw.back();
+    v.emplace_back(t, week.scale(t));
+    cur = &v.back();
+}
+
+void Curves::Reader::lost()
+{
+    curves.dated = true;
+    at_head = false;
+    cur = nullptr;
+}
+
+void Curves::Reader::field(Selection sel, Value val)
+{
+    if(at_head) {
+	curves.head.emplace_back(sel, val);
+    }
+    else {
+	cur->*sel = val;
+    }
+}
+
+void Curves::read(const Week& week, Files& files, std::ostream& err)
+{
+    files.seek([week] (const char* a, const char* b) {
+		   return tail(a, b, week, 1000);
+	       });
+
+    Reader reader{*this, week};
+    scan(files, err,
+	 [&reader] (const std::time_t* t) {
+	     if(t) reader.date(*t);
+	     else reader.lost();
+	 },
+	 [&reader] (Selection sel, const char* a, const char* b) {
+	     if(reader.live()) reader.field(sel, {a, b});
+	 });
+    reader.end();
+}
+
+/**
+ * Read the curves for each of 'weeks' (consecutive, oldest first) in
+ * one pass over 'files'.  The result is the same as reading them one
+ * by one, except that the files are skipped into only as far as the
+ * oldest week allows.
+ */
+std::vector<Curves> Curves::weeks(const std::vector<Week>& weeks,
+				  Files& files, std::ostream& err)
+{
+    std::vector<Curves> v(weeks.size());
+    if(weeks.empty()) return v;
+
+    const Week oldest = weeks.front();
+    files.seek([oldest] (const char* a, const char* b) {
+		   return tail(a, b, oldest, 1000);
+	       });
+
+    std::vector<Reader> readers;
+    readers.reserve(weeks.size());
+    std::vector<Reader*> live;
+    live.reserve(weeks.size());
+    for(size_t i = 0; i < weeks.size(); i++) {
+	readers.emplace_back(v[i], weeks[i]);
+	live.push_back(&readers.back());
+    }
+
+    /* The week containing a time, or rather the first one; a time
+     * at midnight to Monday is also the end of the previous week,
+     * so the last week found is only a shortcut if the one before it
+     * doesn't contain the time too.
+     */
+    size_t n = 0;
+    auto find = [&weeks, &n] (std::time_t t) -> bool {
+		    if(weeks[n].contains(t) &&
+		       (n==0 || !weeks[n-1].contains(t))) return true;
+		    for(n = 0; n < weeks.size(); n++) {
+			if(weeks[n].contains(t)) return true;
+		    }
+		    n = 0;
+		    return false;
+		};
+
+    scan(files, err,
+	 [&] (const std::time_t* t) {
+	     Reader* target[2] = {};
+	     if(t && find(*t)) {
+		 target[0] = &readers[n];
+		 if(n+1 < weeks.size() && weeks[n+1].contains(*t)) {
+		     target[1] = &readers[n+1];
+		 }
+	     }
+	     for(Reader* reader : live) {
+		 if(reader!=target[0] && reader!=target[1]) reader->lost();
+	     }
+	     live.clear();
+	     for(Reader* reader : target) {
+		 if(!reader) continue;
+		 reader->date(*t);
+		 live.push_back(reader);
+	     }
+	 },
+	 [&live] (Selection sel, const char* a, const char* b) {
+	     if(live.empty()) return;
+	     const Value val{a, b};
+	     for(Reader* reader : live) reader->field(sel, val);
+	 });
+
+    for(auto& reader : readers) reader.end();
+    for(auto& curves : v) curves.finish();
+    return v;
+}
+
+/**
+ * Append the curves read from a later file, joining our last curve
+ * and its first one if reading them as one file would have done so.
+ * Until we have seen a date, we keep collecting fields for the head.
+ */
+void Curves::append(Curves&& other)
+{
+    if(!dated) {
+	head.insert(head.end(), other.head.begin(), other.head.end());
+	started_open = other.started_open;
+    }
+    else if(ended_open) {
+	for(const auto& field : other.head) raw.back().back().*field.first = field.second;
+    }
+    if(!other.dated) return;
+
+    auto it = other.raw.begin();
+    if(ended_open && other.started_open) {
+	auto& curve = raw.back();
+	curve.insert(curve.end(), it->begin(), it->end());
+	++it;
+    }
+    raw.insert(raw.end(),
+	       std::make_move_iterator(it),
+	       std::make_move_iterator(other.raw.end()));
+    ended_open = other.ended_open;
+    dated = true;
+}
+
+namespace {
+
+    const Curves::Selection fields[] = {
+	&Curves::Sample::temperature_air,
+	&Curves::Sample::rain_amount,
+	&Curves::Sample::wind_force,
+	&Curves::Sample::wind_force_max,
+	&Curves::Sample::wind_direction,
+    };
+
+    void put(std::ostream& os, Value val)
+    {
+	binary::put<std::int32_t>(os, std::lround(val.value() * 10));
+    }
+
+    bool get(std::istream& is, Value& val)
+    {
+	std::int32_t n;
+	if(!binary::get(is, n)) return false;
+	val = n / 10.0;
+	return true;
+    }
+}
+
+/**
+ * Write the curves as read(), before finish(), in the binary form
+ * load() understands.  For CurveCache.
+ */
+void Curves::save(std::ostream& os) const
+{
+    binary::put<std::uint8_t>(os, dated);
+    binary::put<std::uint8_t>(os, started_open);
+    binary::put<std::uint8_t>(os, ended_open);
+
+    binary::put<std::uint64_t>(os, head.size());
+    for(const auto& field : head) {
+	const auto it = std::find(std::begin(fields), std::end(fields), field.first);
+	binary::put<std::uint8_t>(os, it - std::begin(fields));
+	put(os, field.second);
+    }
+
+    binary::put<std::uint64_t>(os, raw.size());
+    for(const Samples& samples : raw) {
+	binary::put<std::uint64_t>(os, samples.size());
+	for(const Sample& sample : samples) {
+	    binary::put<std::int64_t>(os, sample.epoch);
+	    binary::put(os, sample.t);
+	    for(Selection sel : fields) put(os, sample.*sel);
 	}
-	else if(key=="wind.direction") {
-	    cur->wind_direction = {e, b};
+    }
+}
+
+bool Curves::load(std::istream& is)
+{
+    std::uint8_t a, b, c;
+    std::uint64_t n;
+    if(!binary::get(is, a) ||
+       !binary::get(is, b) ||
+       !binary::get(is, c) ||
+       !binary::get(is, n)) return false;
+    dated = a;
+    started_open = b;
+    ended_open = c;
+
+    while(n--) {
+	std::uint8_t i;
+	Value val;
+	if(!binary::get(is, i) || i >= std::end(fields) - std::begin(fields) || !get(is, val)) return false;
+	head.emplace_back(fields[i], val);
+    }
+
+    if(!binary::get(is, n)) return false;
+    raw.resize(n);
+    for(Samples& samples : raw) {
+	if(!binary::get(is, n)) return false;
+	while(n--) {
+	    std::int64_t epoch;
+	    double t;
+	    if(!binary::get(is, epoch) || !binary::get(is, t)) return false;
+	    samples.emplace_back(epoch, t);
+	    for(Selection sel : fields) {
+		if(!get(is, samples.back().*sel)) return false;
+	    }
 	}
     }
+    return true;
+}
 
-    for(auto& curve : val) {
-	auto e = std::remove_if(std::begin(curve), std::end(curve),
-				[] (Sample s) { return s.empty(); });
-	curve.erase(e, std::end(curve));
+/**
+ * Move the curves into their final shape, dropping samples which
+ * turned out to have no data.
+ */
+void Curves::finish()
+{
+    val.resize(raw.size());
+    for(size_t i = 0; i < raw.size(); i++) {
+	val[i].reserve(raw[i].size());
+	for(const Sample& sample : raw[i]) {
+	    if(!sample.empty()) val[i].push_back(sample);
+	}
     }
+    raw.clear();
+}
+
+
+Curves::Sample Curves::Curve::operator[] (size_t n) const
+{
+    Sample sample{epoch[n], t[n]};
+    sample.temperature_air = temperature_air[n];
+    sample.rain_amount = rain_amount[n];
+    sample.wind_force = wind_force[n];
+    sample.wind_force_max = wind_force_max[n];
+    sample.wind_direction = wind_direction[n];
+    return sample;
+}
+
+void Curves::Curve::reserve(size_t n)
+{
+    epoch.reserve(n);
+    t.reserve(n);
+    temperature_air.reserve(n);
+    rain_amount.reserve(n);
+    wind_force.reserve(n);
+    wind_force_max.reserve(n);
+    wind_direction.reserve(n);
+}
+
+void Curves::Curve::push_back(const Sample& sample)
+{
+    epoch.push_back(sample.epoch);
+    t.push_back(sample.t);
+    temperature_air.push_back(sample.temperature_air);
+    rain_amount.push_back(sample.rain_amount);
+    wind_force.push_back(sample.wind_force);
+    wind_force_max.push_back(sample.wind_force_max);
+    wind_direction.push_back(sample.wind_direction);
 }
@@ -32,22 +32,44 @@
 
 #include <iosfwd>
 #include <vector>
+#include <string>
+#include <utility>
+#include <iterator>
+#include <ctime>
+#include <cstddef>
 
 class Files;
 class Week;
+class CurveCache;
 
 /**
  * 0--more curves for a specific week, read from a set of weather(5)
  * files.  They're several in two ways: there can be both a
  * temperature curve and wind curves, and the same week may appear
  * several times.
+ *
+ * Each Curve is stored as one array per field, so that plotting a
+ * field is a pass over contiguous memory.  For other purposes, a
+ * Curve can be seen as a sequence of Samples.
  */
 class Curves {
 public:
+    Curves() = default;
     Curves(const Week& week, Files& files, std::ostream& err);
+    Curves(const Week& week, const std::vector<std::string>& files,
+	   unsigned jobs, std::ostream& err,
+	   size_t chunk = 4 << 20);
+    Curves(const Week& week, const std::vector<std::string>& files,
+	   unsigned jobs, CurveCache& cache, std::ostream& err,
+	   size_t chunk = 4 << 20);
 
+    /**
+     * A sample, with its time both as it was parsed, and mapped
+     * onto the week as by Week::scale().
+     */
     struct Sample {
-	explicit Sample(double t) : t{t} {};
+	Sample(std::time_t epoch, double t) : epoch{epoch}, t{t} {};
+	std::time_t epoch;
 	double t;
 	Value temperature_air;
 	Value rain_amount;
@@ -64,13 +86,107 @@ public:
     };
 
     using Selection = decltype(&Sample::wind_force);
-    using Curve = std::vector<Sample>;
+
+    class Curve {
+    public:
+	size_t size() const { return t.size(); }
+	bool empty() const { return t.empty(); }
+	Sample operator[] (size_t n) const;
+	Sample front() const { return (*this)[0]; }
+	void push_back(const Sample& sample);
+	void reserve(size_t n);
+
+	class const_iterator;
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	std::vector<std::time_t> epoch;
+	std::vector<double> t;
+	std::vector<Value> temperature_air;
+	std::vector<Value> rain_amount;
+	std::vector<Value> wind_force;
+	std::vector<Value> wind_force_max;
+	std::vector<Value> wind_direction;
+    };
+
+    using Column = std::vector<Value> Curve::*;
+
+    static std::vector<Curves> weeks(const std::vector<Week>& weeks,
+				     Files& files, std::ostream& err);
 
     std::vector<Curve>::const_iterator begin() const { return val.begin(); }
     std::vector<Curve>::const_iterator end() const { return val.end(); }
 
 private:
+    class Reader;
+    void read(const Week& week, const std::vector<std::string>& files,
+	      unsigned jobs, CurveCache* cache, std::ostream& err,
+	      size_t chunk);
+    void read(const Week& week, Files& files, std::ostream& err);
+    void append(Curves&& other);
+    void save(std::ostream& os) const;
+    bool load(std::istream& is);
+    void finish();
+
     std::vector<Curve> val;
+
+    /* While reading, the curves are plain sequences of Samples.
+     */
+    using Samples = std::vector<Sample>;
+    std::vector<Samples> raw;
+
+    /* For joining the curves from consecutive files: fields before
+     * the first date, and if the first and last curves are open
+     * for continuation.
+     */
+    std::vector<std::pair<Selection, Value>> head;
+    bool dated = false;
+    bool started_open = false;
+    bool ended_open = false;
 };
 
+
+/**
+ * Iterating over a Curve, as Samples.  The Samples are assembled
+ * from the columns, so you get copies rather than references.
+ */
+class Curves::Curve::const_iterator {
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = Sample;
+    using difference_type = std::ptrdiff_t;
+    using reference = Sample;
+    struct pointer {
+	Sample sample;
+	const Sample* operator-> () const { return &sample; }
+    };
+
+    const_iterator(const Curve& curve, size_t n) : curve{&curve}, n{n} {}
+
+    Sample operator* () const { return (*curve)[n]; }
+    pointer operator-> () const { return {**this}; }
+    const_iterator& operator++ () { n++; return *this; }
+    const_iterator operator++ (int) { auto it = *this; n++; return it; }
+    const_iterator& operator-- () { n--; return *this; }
+    const_iterator operator-- (int) { auto it = *this; n--; return it; }
+    bool operator== (const const_iterator& other) const { return n==other.n; }
+    bool operator!= (const const_iterator& other) const { return n!=other.n; }
+
+private:
+    const Curve* curve;
+    size_t n;
+};
+
+inline
+Curves::Curve::const_iterator Curves::Curve::begin() const
+{
+    return {*this, 0};
+}
+
+inline
+Curves::Curve::const_iterator Curves::Curve::end() const
+{
+    return {*this, size()};
+}
+
 #endif
@@ -34,15 +34,15 @@
 namespace {
 
     xml::attr attr(const char* name, const char* val) { return {name, val}; }
-    xml::attr attr(const char* name, int val) { return {name, std::to_string(val)}; }
+    xml::attr attr(const char* name, int val) { return {name, val}; }
 
     bool windless(const Curves::Curve& curve)
     {
 	auto windy = [] (const Curves::Sample& sample) {
 			 return !!sample.wind_force;
 		     };
-	auto it = std::find_if(begin(curve), end(curve), windy);
-	return it==end(curve);
+	auto it = std::find_if(std::begin(curve), std::end(curve), windy);
+	return it==std::end(curve);
     }
 
     bool same_dir(const Curves::Sample& a,
@@ -76,7 +76,7 @@ namespace {
 	return (a->t + b->t)/2;
     }
 
-    std::string direction_name(const Curves::Sample& sample)
+    const char* direction_name(const Curves::Sample& sample)
     {
 	switch(unsigned(sample.wind_direction.value())) {
 	case   0: return "N";
@@ -117,8 +117,8 @@ bool direction(xml::ostream& xos, const Area& area,
 	<< attr("text-anchor", "middle")
 	<< attr("y", area.offset + 12 + 6);
 
-    auto a = begin(curve);
-    const auto b = end(curve);
+    auto a = std::begin(curve);
+    const auto b = std::end(curve);
     while(a!=b) {
 	auto c = pop_group2(a, b, same_dir);
 	if(duration(c, a) < 6) continue;
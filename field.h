@@ -0,0 +1,111 @@
+/* -*- c++ -*-
+ *
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WEATHER_FIELD_H
+#define WEATHER_FIELD_H
+
+#include <algorithm>
+#include <cctype>
+
+/**
+ * Splitting a weather(5) line into its field name and value.
+ *
+ *   "   foo   :   bar  "
+ *       a  d  c   e  b
+ *
+ * After a successful split(), the name is [a, d) and the value
+ * [e, b), both trimmed of whitespace.
+ */
+namespace field {
+
+    inline bool isspace(char ch)
+    {
+	return std::isspace(static_cast<unsigned char>(ch));
+    }
+
+    /**
+     * Trim whitespace to the left in [a, b).
+     */
+    inline
+    const char* ws(const char* a, const char* b)
+    {
+	while(a!=b && isspace(*a)) a++;
+	return a;
+    }
+
+    /**
+     * Trim whitespace to the right in [a, b), so that
+     * it's either empty or ends with non-whitespace.
+     */
+    inline
+    const char* trimr(const char* a, const char* b)
+    {
+	while(a!=b && isspace(*(b-1))) b--;
+	return b;
+    }
+
+    struct Field {
+	const char* name;
+	const char* name_end;
+	const char* val;
+	const char* val_end;
+    };
+
+    enum class Kind { nothing, field, malformed };
+
+    /**
+     * Split the line [a, b) into a Field, or classify it as
+     * nothing (blank or comment), or as malformed.
+     */
+    inline
+    Kind split(Field& f, const char* a, const char* b)
+    {
+	a = ws(a, b);
+	b = trimr(a, b);
+	if(a==b || *a=='#') return Kind::nothing;
+	const char* const c = std::find(a, b, ':');
+	if(c==b) return Kind::malformed;
+	const char* const d = trimr(a, c);
+	const char* const e = ws(c+1, b);
+	if(a==d || e==b) return Kind::malformed;
+
+	f = {a, d, e, b};
+	return Kind::field;
+    }
+
+    /**
+     * True if the field has name 's'.
+     */
+    template <size_t N>
+    bool is(const Field& f, const char (&s)[N])
+    {
+	return size_t(f.name_end - f.name) == N-1 &&
+	    std::equal(f.name, f.name_end, s);
+    }
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include "files...h"
 
 #include <cstring>
+#include <algorithm>
 
 
 /**
@@ -13,19 +14,49 @@
  * stdin.
  */
 Files::Files(std::stringstream& ss)
-    : is(&ss),
+    : started(true),
+      is(&ss),
+      range{nullptr, nullptr, nullptr},
+      skipped(nullptr),
       pos{"<string>", 0}
 {}
 
 
+/**
+ * Reading [a, b), which is part of the file 'name' which starts at
+ * 'origin'.  The data must outlive the Files.
+ */
+Files::Files(const std::string& name,
+	     const char* origin, const char* a, const char* b)
+    : started(true),
+      is(nullptr),
+      range{origin, a, b},
+      skipped(a),
+      pos{name, 0}
+{}
+
+
+Files::~Files()
+{
+    close();
+}
+
+
 /**
  * The input position, on the traditional "file:line"
  * format. Standard input is called "<stdin>".
  *
  * Undefined unless the last getline() was successful.
+ *
+ * If seek() made us skip part of the file, we count the lines we
+ * skipped now, since it's rarely needed.
  */
 const Files::Position& Files::position() const
 {
+    if(skipped) {
+	pos.line += std::count(range.origin, skipped, '\n');
+	skipped = nullptr;
+    }
     return pos;
 }
 
@@ -36,7 +67,7 @@ const Files::Position& Files::position() const
  */
 Files::Position Files::prev_position() const
 {
-    Position p{pos};
+    Position p{position()};
     p.line--;
     return p;
 }
@@ -49,21 +80,22 @@ std::ostream& operator<< (std::ostream& os, const Files::Position& val)
 
 
 /**
- * The slowpath part of getline(). Called whenever an ordinary
- * std::getline() fails.
+ * The slowpath part of getline(). Called whenever the current file
+ * (if any) is exhausted.
  */
-bool Files::getline_helper(std::string& s)
+bool Files::getline_helper(const char*& a, const char*& b)
 {
     if(ff.empty()) return false;
 
-    if(!is && f==ff.begin()) {
+    if(!started) {
 	/* first getline() ever */
+	started = true;
 	open();
     }
 
-    while(!std::getline(*is, s)) {
+    while(!next(a, b)) {
 
-	fs.close();
+	close();
 	f++;
 	if(f==ff.end()) {
 	    return false;
@@ -77,19 +109,54 @@ bool Files::getline_helper(std::string& s)
 }
 
 
+/**
+ * Open *f: mmap(2) it if it's a regular file, otherwise fall back to
+ * reading it as a stream.  For a mapped file, the seek() function
+ * decides where in it to start reading.
+ */
 void Files::open()
 {
     if(*f=="-") {
 	pos = {"<stdin>", 1};
 	is = &std::cin;
+	return;
+    }
+
+    pos = {*f, 1};
+    map = Mapping{*f};
+    if(map.error()) {
+	std::cerr << "error: cannot open '" << pos.file
+		  << "' for reading: " << std::strerror(map.error()) << '\n';
+	return;
     }
-    else {
-	pos = {*f, 1};
-	fs.open(*f, std::ios_base::in);
-	is = &fs;
-	if(!fs.is_open()) {
-	    std::cerr << "error: cannot open '" << pos.file
-		      << "' for reading: " << std::strerror(errno) << '\n';
+
+    if(map.mapped()) {
+	range = {map.begin(), map.begin(), map.end()};
+	if(seek_ && range.p != range.end) {
+	    range.p = seek_(range.p, range.end);
+	    skipped = range.p;
 	}
+	return;
+    }
+
+    fs.open(*f, std::ios_base::in);
+    is = &fs;
+    if(!fs.is_open()) {
+	std::cerr << "error: cannot open '" << pos.file
+		  << "' for reading: " << std::strerror(errno) << '\n';
     }
 }
+
+
+/**
+ * Close the current file, if there is one (the mapping, or the
+ * std::ifstream).
+ */
+void Files::close()
+{
+    map = Mapping{};
+    range = {nullptr, nullptr, nullptr};
+    skipped = nullptr;
+    if(is==&fs) fs.close();
+    if(!ff.empty()) is = nullptr;
+}
@@ -11,6 +11,10 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cstring>
+#include <functional>
+
+#include "mapping.h"
 
 
 /**
@@ -29,6 +33,13 @@
  *
  * Also support for reading from a std::stringstream, but that's
  * mostly so that other classes which read from Files can be tested.
+ *
+ * Regular files are mmap(2)ed, and getline(a, b) hands out lines as
+ * ranges into the mapping, without copying.  Standard input, pipes
+ * and the like are read the traditional way, through a line buffer.
+ *
+ * Since the whole of a mapped file is available, a reader can also
+ * choose to skip the beginning of it; see seek().
  */
 class Files {
 public:
@@ -37,8 +48,12 @@ public:
 	  bool empty_is_stdin = true);
 
     explicit Files(std::stringstream& ss);
+    Files(const std::string& name,
+	  const char* origin, const char* a, const char* b);
+    ~Files();
 
     bool getline(std::string& s);
+    bool getline(const char*& a, const char*& b);
 
     struct Position {
 	Position(const std::string& file, const unsigned line)
@@ -51,35 +66,91 @@ public:
     const Position& position() const;
     Position prev_position() const;
 
+    /* For mapped files, start reading at f(begin, end) instead
+     * of at the beginning.
+     */
+    using Seek = std::function<const char* (const char*, const char*)>;
+    void seek(const Seek& f) { seek_ = f; }
+
 private:
     Files(const Files&);
     Files& operator= (const Files&);
 
-    bool getline_helper(std::string& s);
+    bool getline_helper(const char*& a, const char*& b);
+    bool next(const char*& a, const char*& b);
     void open();
+    void close();
 
     std::vector<std::string> ff;
     std::vector<std::string>::const_iterator f;
+    bool started;
     std::istream* is;
     std::ifstream fs;
-    Position pos;
+    std::string buf;
+    Mapping map;
+    struct {
+	const char* origin;
+	const char* p;
+	const char* end;
+    } range;
+    Seek seek_;
+    mutable const char* skipped;
+    mutable Position pos;
 };
 
 
 /**
- * Like std::getline(string&), but operates on the sequence of lines
- * formed by all involved files.  When it returns success, a line is
- * filled into 's' and position() is correct.
+ * The next line of the current file, if any, without bookkeeping.
  */
 inline
-bool Files::getline(std::string& s)
+bool Files::next(const char*& a, const char*& b)
+{
+    if(range.p != range.end) {
+	a = range.p;
+	auto nl = static_cast<const char*>(std::memchr(a, '\n', range.end - a));
+	b = nl ? nl : range.end;
+	range.p = nl ? nl + 1 : range.end;
+	return true;
+    }
+    if(is && std::getline(*is, buf)) {
+	a = buf.data();
+	b = a + buf.size();
+	return true;
+    }
+    return false;
+}
+
+
+/**
+ * Like getline(string&), but the line is [a, b) and there's no
+ * copying, at least not for regular files.  The range is valid until
+ * the next call.
+ */
+inline
+bool Files::getline(const char*& a, const char*& b)
 {
     pos.line++;
-    if(is && std::getline(*is, s)) {
+    if(next(a, b)) {
 	return true;
     }
 
-    return getline_helper(s);
+    return getline_helper(a, b);
+}
+
+
+/**
+ * Like std::getline(string&), but operates on the sequence of lines
+ * formed by all involved files.  When it returns success, a line is
+ * filled into 's' and position() is correct.
+ */
+inline
+bool Files::getline(std::string& s)
+{
+    const char* a;
+    const char* b;
+    if(!getline(a, b)) return false;
+    s.assign(a, b);
+    return true;
 }
 
 
@@ -91,7 +162,10 @@ template <class It>
 Files::Files(It begin, It end,
 	     bool empty_is_stdin)
     : ff(begin, end),
+      started(false),
       is(0),
+      range{nullptr, nullptr, nullptr},
+      skipped(nullptr),
       pos{"", 0}
 {
     if(ff.empty() && empty_is_stdin) ff.push_back("-");
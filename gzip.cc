@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "gzip.h"
+
+#include <iostream>
+#include <zlib.h>
+
+
+Gzip::Gzip(std::ostream& os, int level)
+    : z{new z_stream{}},
+      os(os)
+{
+    /* 15 bits of window, plus 16 for a gzip header and trailer */
+    ok = deflateInit2(z, level, Z_DEFLATED, 15 + 16, 8,
+		      Z_DEFAULT_STRATEGY) == Z_OK;
+}
+
+Gzip::~Gzip()
+{
+    deflateEnd(z);
+    delete z;
+}
+
+/**
+ * Compress what remains and end the gzip stream.  Returns false if
+ * compression or writing failed at any point.
+ */
+bool Gzip::finish()
+{
+    if(!finished) {
+	finished = true;
+	if(ok) ok = deflate(nullptr, 0, Z_FINISH);
+    }
+    return ok && os.flush();
+}
+
+Gzip::int_type Gzip::overflow(int_type c)
+{
+    if(c == traits_type::eof()) return traits_type::not_eof(c);
+    const char ch = traits_type::to_char_type(c);
+    if(!xsputn(&ch, 1)) return traits_type::eof();
+    return c;
+}
+
+std::streamsize Gzip::xsputn(const char* p, std::streamsize n)
+{
+    if(!ok || finished) return 0;
+    in_ += n;
+    ok = deflate(p, n, Z_NO_FLUSH);
+    return ok ? n : 0;
+}
+
+/**
+ * Feed [p, p+n) to deflate, and write its output in buffer-sized
+ * blocks.
+ */
+bool Gzip::deflate(const char* p, size_t n, int flush)
+{
+    z->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(p));
+    z->avail_in = n;
+    do {
+	z->next_out = reinterpret_cast<Bytef*>(buf);
+	z->avail_out = sizeof buf;
+	const int err = ::deflate(z, flush);
+	if(err != Z_OK && err != Z_STREAM_END && err != Z_BUF_ERROR) return false;
+	const size_t len = sizeof buf - z->avail_out;
+	out_ += len;
+	if(!os.write(buf, len)) return false;
+    } while(z->avail_out == 0 || (flush == Z_FINISH && z->avail_in));
+    return true;
+}
@@ -0,0 +1,79 @@
+/* -*- c++ -*-
+ *
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WEATHER_GZIP_H
+#define WEATHER_GZIP_H
+
+#include <streambuf>
+#include <iosfwd>
+#include <cstddef>
+
+struct z_stream_s;
+
+/**
+ * A std::streambuf which compresses what's written to it into the
+ * gzip format (RFC 1952), and writes the result to another
+ * std::ostream as it goes.  Nothing is buffered uncompressed except
+ * what deflate itself holds on to.
+ *
+ *   Gzip gz {file, 9};
+ *   std::ostream os {&gz};
+ *   os << ...;
+ *   if(!gz.finish()) ...
+ *
+ * The compression level is as for zlib: 1 (fastest) to 9 (best).
+ * Nothing may be written after finish().
+ */
+class Gzip : public std::streambuf {
+public:
+    Gzip(std::ostream& os, int level);
+    ~Gzip();
+    Gzip(const Gzip&) = delete;
+    Gzip& operator= (const Gzip&) = delete;
+
+    bool finish();
+
+    size_t in() const { return in_; }
+    size_t out() const { return out_; }
+
+protected:
+    int_type overflow(int_type c) override;
+    std::streamsize xsputn(const char* p, std::streamsize n) override;
+
+private:
+    bool deflate(const char* p, size_t n, int flush);
+
+    z_stream_s* const z;
+    std::ostream& os;
+    bool ok;
+    bool finished = false;
+    size_t in_ = 0;
+    size_t out_ = 0;
+    char buf[1 << 14];
+};
+
+#endif
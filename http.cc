@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "http.h"
+
+#include <sstream>
+#include <cctype>
+#include <cstdlib>
+
+namespace {
+
+    std::string lower(std::string s)
+    {
+	for(char& c : s) c = std::tolower(static_cast<unsigned char>(c));
+	return s;
+    }
+
+    std::string trim(const std::string& s)
+    {
+	const size_t a = s.find_first_not_of(" \t\r");
+	if(a==std::string::npos) return "";
+	return s.substr(a, s.find_last_not_of(" \t\r") + 1 - a);
+    }
+
+    const char* reason(unsigned status)
+    {
+	switch(status) {
+	case 200: return "OK";
+	case 400: return "Bad Request";
+	case 404: return "Not Found";
+	case 405: return "Method Not Allowed";
+	case 500: return "Internal Server Error";
+	default: return "Unknown";
+	}
+    }
+}
+
+/**
+ * Parse the request at the start of 'buf', setting 'n' to its size.
+ * It's incomplete until all of the header is there.  Requests with
+ * a body are bad, since there's nothing to post to.  A connection is
+ * kept alive for HTTP/1.1 unless the client asks to close it, and
+ * for HTTP/1.0 only if it asks to keep it.
+ */
+http::Parse http::parse(const std::string& buf, size_t& n, Request& req)
+{
+    size_t end = buf.find("\r\n\r\n");
+    if(end==std::string::npos) {
+	return buf.size() > http::limit ? Parse::bad : Parse::incomplete;
+    }
+    n = end + 4;
+    if(end > http::limit) return Parse::bad;
+
+    std::istringstream is {buf.substr(0, end)};
+    std::string line;
+    std::getline(is, line);
+    std::istringstream ls {line};
+    std::string version;
+    std::string rest;
+    if(!(ls >> req.method >> req.target >> version) || ls >> rest) return Parse::bad;
+    if(version.compare(0, 5, "HTTP/")) return Parse::bad;
+    req.keep_alive = version!="HTTP/1.0";
+
+    while(std::getline(is, line)) {
+	const size_t colon = line.find(':');
+	if(colon==std::string::npos) return Parse::bad;
+	const std::string name = lower(line.substr(0, colon));
+	const std::string val = lower(trim(line.substr(colon + 1)));
+	if(name=="connection") {
+	    if(val=="close") req.keep_alive = false;
+	    if(val=="keep-alive") req.keep_alive = true;
+	}
+	if(name=="transfer-encoding") return Parse::bad;
+	if(name=="content-length" && std::strtoul(val.c_str(), nullptr, 10)) return Parse::bad;
+    }
+    return Parse::ok;
+}
+
+/**
+ * The status line and headers of a response, with the body to
+ * follow.
+ */
+std::string http::header(unsigned status, const char* type,
+			 size_t length, bool keep_alive)
+{
+    std::ostringstream os;
+    os << "HTTP/1.1 " << status << ' ' << reason(status) << "\r\n"
+       << "Content-Type: " << type << "\r\n"
+       << "Content-Length: " << length << "\r\n"
+       << "Connection: " << (keep_alive ? "keep-alive" : "close") << "\r\n"
+       << "\r\n";
+    return os.str();
+}
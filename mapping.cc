@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "mapping.h"
+
+#include <utility>
+#include <cerrno>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+Mapping::Mapping(const std::string& path)
+{
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd==-1) {
+	err = errno;
+	return;
+    }
+
+    struct stat st;
+    if(fstat(fd, &st)==0 && S_ISREG(st.st_mode)) {
+	size = st.st_size;
+	ino = st.st_ino;
+	mtim = st.st_mtim.tv_sec * std::int64_t{1000000000} + st.st_mtim.tv_nsec;
+	void* p = size ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+	if(p != MAP_FAILED) {
+	    if(p) posix_madvise(p, size, POSIX_MADV_SEQUENTIAL);
+	    base = p;
+	    ok = true;
+	}
+	else {
+	    size = 0;
+	}
+    }
+    close(fd);
+}
+
+Mapping::~Mapping()
+{
+    if(base) munmap(base, size);
+}
+
+Mapping::Mapping(Mapping&& other)
+    : base{other.base},
+      size{other.size},
+      ino{other.ino},
+      mtim{other.mtim},
+      ok{other.ok},
+      err{other.err}
+{
+    other.base = nullptr;
+    other.size = 0;
+    other.ok = false;
+}
+
+Mapping& Mapping::operator= (Mapping&& other)
+{
+    std::swap(base, other.base);
+    std::swap(size, other.size);
+    std::swap(ino, other.ino);
+    std::swap(mtim, other.mtim);
+    std::swap(ok, other.ok);
+    std::swap(err, other.err);
+    return *this;
+}
@@ -0,0 +1,70 @@
+/* -*- c++ -*-
+ *
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WEATHER_MAPPING_H
+#define WEATHER_MAPPING_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * A read-only mmap(2) of a regular file.  If the file couldn't be
+ * opened, error() says why.  If it isn't a regular file, or can't be
+ * mapped for some other reason, it's not mapped() and the caller
+ * has to read it some other way.
+ *
+ * The inode and modification time (in ns) identify the version of
+ * the file which got mapped.
+ */
+class Mapping {
+public:
+    Mapping() = default;
+    explicit Mapping(const std::string& path);
+    ~Mapping();
+    Mapping(const Mapping&) = delete;
+    Mapping& operator= (const Mapping&) = delete;
+    Mapping(Mapping&& other);
+    Mapping& operator= (Mapping&& other);
+
+    int error() const { return err; }
+    bool mapped() const { return ok; }
+    const char* begin() const { return static_cast<const char*>(base); }
+    const char* end() const { return begin() + size; }
+    std::uint64_t inode() const { return ino; }
+    std::int64_t mtime() const { return mtim; }
+
+private:
+    void* base = nullptr;
+    size_t size = 0;
+    std::uint64_t ino = 0;
+    std::int64_t mtim = 0;
+    bool ok = false;
+    int err = 0;
+};
+
+#endif
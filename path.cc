@@ -29,7 +29,8 @@
 #include "reckon.h"
 #include "groups.h"
 
-#include <sstream>
+#include <algorithm>
+#include <cmath>
 
 
 /**
@@ -40,8 +41,10 @@
  *   M x y  l dx dy dx dy ...
  *   M x y  l dx dy dx dy ...
  *   ...
+ *
+ * The string 's' is overwritten, but its memory reused.
  */
-std::string path::line(double hour, const std::vector<std::pair<double, double>>& v)
+std::string& path::line(std::string& s, double hour, const Points& v)
 {
     auto begin = std::begin(v);
     const auto end = std::end(v);
@@ -52,26 +55,25 @@ std::string path::line(double hour, const std::vector<std::pair<double, double>>
 		    auto t1 = b.first;
 		    return t1 <= t0 || t0 + hour < t1;
 		};
-    std::ostringstream ss;
+    s.clear();
 
     while(begin != end) {
 	auto a = pop_group(begin, end, hole);
 	if(std::distance(a, begin) < 2) continue;
 
-	reckon(ss, a, begin) << '\n';
+	reckon(s, a, begin) += '\n';
     }
-    std::string s = ss.str();
     if(s.size()) s.pop_back();
     return s;
 }
 
 namespace {
 
-    using V = std::vector<std::pair<double, double>>;
+    using V = path::Points;
 
     /**
      * Given a subsequence of 'v' with either all rain or no rain,
-     * return something fill-able.
+     * make 'acc' something fill-able.
      *
      * - No rain: return an empty sequence.
      *
@@ -79,11 +81,12 @@ namespace {
      *   with no rain is present.  If v begins or ends with rain
      *   (t, r), do it by adding a sample (t, nil).
      */
-    V shover(V::const_iterator a, V::const_iterator b,
-	     const V& v,
-	     const double nil)
+    V& shover(V& acc,
+	      V::const_iterator a, V::const_iterator b,
+	      const V& v,
+	      const double nil)
     {
-	V acc;
+	acc.clear();
 	if(a->second==nil) return acc;
 
 	if(a==begin(v)) {
@@ -122,8 +125,11 @@ namespace {
  *    3  4.0  M 2 0  L 3 4
  *    4  3.0  L 4 3  L 4 0
  *    end
+ *
+ * Like 's', 'scratch' is overwritten.
  */
-std::string path::fill(double nil, const std::vector<std::pair<double, double>>& v)
+std::string& path::fill(std::string& s, Points& scratch,
+			double nil, const Points& v)
 {
     auto begin = std::begin(v);
     const auto end = std::end(v);
@@ -135,16 +141,157 @@ std::string path::fill(double nil, const std::vector<std::pair<double, double>>&
 		      bool bdry = b.second == nil;
 		      return adry ^ bdry;
 		  };
-    std::ostringstream ss;
+    s.clear();
 
     while(begin != end) {
 	auto a = pop_group(begin, end, change);
-	auto sh = shover(a, begin, v, nil);
+	const auto& sh = shover(scratch, a, begin, v, nil);
 	if(sh.empty()) continue;
 
-	reckon(ss, std::begin(sh), std::end(sh)) << '\n';
+	reckon(s, std::begin(sh), std::end(sh)) += '\n';
     }
-    std::string s = ss.str();
     if(s.size()) s.pop_back();
     return s;
 }
+
+namespace {
+
+    using P = std::pair<double, double>;
+
+    /**
+     * The square of the distance from c to the line through a and b,
+     * or to a if they coincide.
+     */
+    double distance2(const P& a, const P& b, const P& c)
+    {
+	const double dx = b.first - a.first;
+	const double dy = b.second - a.second;
+	const double ex = c.first - a.first;
+	const double ey = c.second - a.second;
+	const double len2 = dx*dx + dy*dy;
+	if(len2==0) return ex*ex + ey*ey;
+	const double cross = dx*ey - dy*ex;
+	return cross*cross / len2;
+    }
+
+    /**
+     * Ramer-Douglas-Peucker on [a, b]: append to 'out' the points in
+     * (a, b] which are needed to stay within the tolerance, and keep
+     * the kept points no further than 'span' apart in x.
+     *
+     * 'out' may be written over the range itself, because it never
+     * passes the point being read.
+     */
+    V::iterator rdp(V::iterator out,
+		    V::const_iterator a, V::const_iterator b,
+		    double tol2, double span)
+    {
+	auto worst = a;
+	double dmax = 0;
+	for(auto it = a+1; it != b; it++) {
+	    const double d = distance2(*a, *b, *it);
+	    if(d > dmax) {
+		dmax = d;
+		worst = it;
+	    }
+	}
+	if(dmax <= tol2 && b->first - a->first > span && b - a > 1) {
+	    worst = a + (b - a)/2;
+	    dmax = tol2 + 1;
+	}
+	if(dmax <= tol2) {
+	    *out++ = *b;
+	    return out;
+	}
+	out = rdp(out, a, worst, tol2, span);
+	return rdp(out, worst, b, tol2, span);
+    }
+
+    /**
+     * Simplify each group of 'v' (as split by 'cut') on its own,
+     * keeping its first and last points.
+     */
+    template <class Pred>
+    void simplify(V& v, double tolerance, double span, Pred cut)
+    {
+	const double tol2 = tolerance * tolerance;
+	V::const_iterator begin = std::begin(v);
+	const V::const_iterator end = std::end(v);
+	auto out = std::begin(v);
+
+	while(begin != end) {
+	    auto a = pop_group(begin, end, cut);
+	    *out++ = *a;
+	    if(begin - a > 1) out = rdp(out, a, begin - 1, tol2, span);
+	}
+	v.erase(out, std::end(v));
+    }
+}
+
+/**
+ * Thin out a line before line(): drop points which are within
+ * 'tolerance' of the line between their neighbours.  This doesn't
+ * create new holes: points are never dropped across one, nor so that
+ * the remaining ones get more than an hour apart.
+ *
+ * The remaining points are unchanged, so Reckon still places them
+ * correctly.
+ */
+void path::simplify(Points& v, double tolerance, double hour)
+{
+    auto hole = [hour] (const P& a, const P& b) {
+		    return b.first <= a.first || a.first + hour < b.first;
+		};
+    ::simplify(v, tolerance, hour, hole);
+}
+
+/**
+ * Like simplify(), but for fill(): the changes to and from rain are
+ * kept.
+ */
+void path::simplify_fill(Points& v, double tolerance, double nil)
+{
+    auto change = [nil] (const P& a, const P& b) {
+		      return (a.second == nil) ^ (b.second == nil);
+		  };
+    ::simplify(v, tolerance, HUGE_VAL, change);
+}
+
+/**
+ * M4 decimation: of the points falling in the same pixel column (the
+ * same integer part of x) keep the first, the last, and the ones with
+ * the lowest and highest y.  Drawn with lines at that resolution,
+ * the result looks the same as the full curve, but it has at most
+ * four points per column.
+ *
+ * A run of points in a column ends where x doesn't increase, so
+ * the backtracking line() sees as holes is kept.
+ */
+void path::decimate(Points& v)
+{
+    auto out = std::begin(v);
+    auto a = std::begin(v);
+    const auto end = std::end(v);
+
+    while(a != end) {
+	const double col = std::floor(a->first);
+	auto b = a + 1;
+	auto lo = a;
+	auto hi = a;
+	while(b != end && (b-1)->first < b->first && std::floor(b->first)==col) {
+	    if(b->second < lo->second) lo = b;
+	    if(hi->second < b->second) hi = b;
+	    b++;
+	}
+
+	V::const_iterator keep[4] = {a, lo, hi, b-1};
+	std::sort(keep, keep+4);
+	const P p[4] = {*keep[0], *keep[1], *keep[2], *keep[3]};
+	for(unsigned i = 0; i < 4; i++) {
+	    if(i && keep[i]==keep[i-1]) continue;
+	    *out++ = p[i];
+	}
+	a = b;
+    }
+    v.erase(out, end);
+}
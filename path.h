@@ -35,8 +35,15 @@
 
 namespace path {
 
-    std::string line(double hour, const std::vector<std::pair<double, double>>& v);
-    std::string fill(double nil, const std::vector<std::pair<double, double>>& v);
+    using Points = std::vector<std::pair<double, double>>;
+
+    std::string& line(std::string& s, double hour, const Points& v);
+    std::string& fill(std::string& s, Points& scratch,
+		      double nil, const Points& v);
+
+    void decimate(Points& v);
+    void simplify(Points& v, double tolerance, double hour);
+    void simplify_fill(Points& v, double tolerance, double nil);
 }
 
 #endif
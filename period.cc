@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "period.h"
+
+#include "timestamp.h"
+
+#include <iostream>
+#include <cstdio>
+#include <ctime>
+#include <time.h>
+
+using std::time_t;
+
+namespace {
+
+    std::tm local(time_t t)
+    {
+	std::tm tm;
+	localtime_r(&t, &tm);
+	return tm;
+    }
+
+    time_t parse(const std::string& ts)
+    {
+	time_t t = 0;
+	timestamp::parse(ts, t);
+	return t;
+    }
+
+    /**
+     * Local midnight at the start of day 'mday' of month 'mon' (which
+     * may be outside 0--11, or 'mday' outside the month, as mktime(3)
+     * normalizes).
+     */
+    time_t midnight(int year, int mon, int mday)
+    {
+	std::tm tm {};
+	tm.tm_year = year;
+	tm.tm_mon = mon;
+	tm.tm_mday = mday;
+	tm.tm_isdst = -1;
+	return std::mktime(&tm);
+    }
+
+    std::string date(time_t t)
+    {
+	const std::tm tm = local(t);
+	char buf[30];
+	std::snprintf(buf, sizeof buf, "%04d-%02d-%02d",
+		      tm.tm_year + 1900,
+		      tm.tm_mon + 1,
+		      tm.tm_mday);
+	return buf;
+    }
+
+    std::string format(time_t t, const char* fmt)
+    {
+	const std::tm tm = local(t);
+	char buf[200];
+	const size_t n = std::strftime(buf, sizeof buf, fmt, &tm);
+	return {buf, n};
+    }
+
+    /**
+     * Like Week::scale(): map t linearly so that 'begin' is 0 and
+     * 'end' is 1.
+     */
+    double scale(time_t begin, time_t end, time_t t)
+    {
+	const time_t dt = t - begin;
+	return double(dt)/(end - begin);
+    }
+}
+
+
+
+template <class Unit>
+Calendar<Unit>::Calendar(std::time_t t)
+{
+    const std::tm tm = local(t);
+    begin = Unit::start(tm, 0);
+    end = Unit::start(tm, 1);
+}
+
+template <class Unit>
+Calendar<Unit>::Calendar(const std::string& ts)
+    : Calendar(parse(ts))
+{}
+
+template <class Unit>
+double Calendar<Unit>::scale(time_t t) const
+{
+    return ::scale(begin, end, t);
+}
+
+/**
+ * Like Week::scale(ts), but unparsable timestamps map to -1.
+ */
+template <class Unit>
+double Calendar<Unit>::scale(const std::string& ts) const
+{
+    time_t t;
+    if(!timestamp::parse(ts, t)) return -1;
+    return scale(t);
+}
+
+template <class Unit>
+Calendar<Unit> Calendar<Unit>::prev() const
+{
+    return Calendar {begin - 1};
+}
+
+template <class Unit>
+std::string Calendar<Unit>::first() const
+{
+    return date(begin);
+}
+
+template <class Unit>
+std::string Calendar<Unit>::last() const
+{
+    return date(end - 1);
+}
+
+/**
+ * Where the divisions begin, except the first, on the 0--1 scale.
+ */
+template <class Unit>
+std::vector<double> Calendar<Unit>::borders() const
+{
+    const std::tm tm = local(begin);
+    std::vector<double> v;
+    for(int n = 1; ; n++) {
+	const time_t t = Unit::border(tm, n);
+	if(t >= end) break;
+	v.push_back(scale(t));
+    }
+    return v;
+}
+
+/**
+ * The first day of the period formatted as by strftime(3).
+ */
+template <class Unit>
+std::string Calendar<Unit>::format(const char* fmt) const
+{
+    return ::format(begin, fmt);
+}
+
+template <class Unit>
+std::ostream& Calendar<Unit>::put(std::ostream& os) const
+{
+    return Unit::put(os, local(begin));
+}
+
+template class Calendar<MonthUnit>;
+template class Calendar<YearUnit>;
+
+
+time_t MonthUnit::start(const std::tm& tm, int n)
+{
+    return midnight(tm.tm_year, tm.tm_mon + n, 1);
+}
+
+/**
+ * Midnight starting day n+1 of the month.
+ */
+time_t MonthUnit::border(const std::tm& tm, int n)
+{
+    return midnight(tm.tm_year, tm.tm_mon, 1 + n);
+}
+
+/**
+ * Pretty-print the month, like "10.2018".
+ */
+std::ostream& MonthUnit::put(std::ostream& os, const std::tm& tm)
+{
+    return os << tm.tm_mon + 1 << '.' << tm.tm_year + 1900;
+}
+
+
+time_t YearUnit::start(const std::tm& tm, int n)
+{
+    return midnight(tm.tm_year + n, 0, 1);
+}
+
+/**
+ * The start of month n (where 0 is January).
+ */
+time_t YearUnit::border(const std::tm& tm, int n)
+{
+    return midnight(tm.tm_year, n, 1);
+}
+
+/**
+ * Pretty-print the year, like "2018".
+ */
+std::ostream& YearUnit::put(std::ostream& os, const std::tm& tm)
+{
+    return os << tm.tm_year + 1900;
+}
@@ -0,0 +1,117 @@
+/* -*- c++ -*-
+ *
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WEATHER_PERIOD_H
+#define WEATHER_PERIOD_H
+
+#include <ctime>
+#include <string>
+#include <vector>
+#include <iosfwd>
+
+
+/**
+ * A calendar period in local time, specified by a time point in it:
+ * a Month or a Year.  Like Week, you can map times onto it and find
+ * the preceding one.
+ *
+ * What kind of period it is, and how it's divided (into days or
+ * months), is up to the 'Unit':
+ *
+ * - start(tm, n): the start of the n:th period after the one
+ *   containing 'tm'
+ * - border(tm, n): the start of its n:th division, for n > 0
+ * - put(os, tm): pretty-print the period starting at 'tm'
+ * - hourly: if it's plotted from the hourly rollups, rather than
+ *   the daily ones
+ */
+template <class Unit>
+class Calendar {
+public:
+    explicit Calendar(std::time_t t);
+    explicit Calendar(const std::string& ts);
+
+    bool operator== (const Calendar& other) const {
+	return begin == other.begin;
+    }
+    bool operator!= (const Calendar& other) const {
+	return !(*this == other);
+    }
+
+    double scale(std::time_t t) const;
+    double scale(const std::string& ts) const;
+    bool contains(std::time_t t) const { return begin <= t && t <= end; }
+
+    Calendar prev() const;
+    std::string first() const;
+    std::string last() const;
+    std::vector<double> borders() const;
+    std::string format(const char* fmt) const;
+    std::ostream& put(std::ostream& os) const;
+
+    static constexpr bool hourly = Unit::hourly;
+
+private:
+    time_t begin;
+    time_t end;
+};
+
+/**
+ * A calendar month, divided into days.  The plots of months are of
+ * the hourly rollups.
+ */
+struct MonthUnit {
+    static std::time_t start(const std::tm& tm, int n);
+    static std::time_t border(const std::tm& tm, int n);
+    static std::ostream& put(std::ostream& os, const std::tm& tm);
+    static constexpr bool hourly = true;
+};
+
+/**
+ * A calendar year, divided into months.  The plots are of the daily
+ * rollups.
+ */
+struct YearUnit {
+    static std::time_t start(const std::tm& tm, int n);
+    static std::time_t border(const std::tm& tm, int n);
+    static std::ostream& put(std::ostream& os, const std::tm& tm);
+    static constexpr bool hourly = false;
+};
+
+using Month = Calendar<MonthUnit>;
+using Year = Calendar<YearUnit>;
+
+extern template class Calendar<MonthUnit>;
+extern template class Calendar<YearUnit>;
+
+template <class Unit>
+std::ostream& operator<< (std::ostream& os, const Calendar<Unit>& val)
+{
+    return val.put(os);
+}
+
+#endif
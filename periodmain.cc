@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "periodmain.h"
+
+#include "plot.h"
+#include "area.h"
+#include "period.h"
+#include "rollup.h"
+#include "files...h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <cerrno>
+
+#include <getopt.h>
+
+
+namespace {
+
+    /**
+     * Read one Rollup per file: either a rollup file as written by
+     * weather_rollup(1), or weather(5) data which is aggregated on
+     * the fly, for the period only.  Returns false on errors.
+     */
+    template <class Period>
+    bool read(std::vector<Rollup>& rollups,
+	      const Period& period, bool is_rollup,
+	      const std::vector<std::string>& files)
+    {
+	for(const auto& file : files) {
+	    if(!is_rollup) {
+		Files ff {&file, &file + 1};
+		rollups.emplace_back(ff, period.first(), period.last());
+		continue;
+	    }
+
+	    rollups.emplace_back();
+	    if(file=="-") {
+		if(!rollups.back().read(std::cin)) return false;
+		continue;
+	    }
+	    std::ifstream is {file};
+	    if(!is || !rollups.back().read(is)) {
+		std::cerr << "cannot read '" << file << "': "
+			  << std::strerror(errno) << '\n';
+		return false;
+	    }
+	}
+	return true;
+    }
+
+    template <class Period>
+    int plot_period(const Period& period,
+		    const std::vector<Rollup>& rollups,
+		    std::ostream& os)
+    {
+	const Area temperature{{-20, +30}, {700, 200}};
+	const SubArea rain{temperature, {0, 20}, 200 * 3/5};
+	const Area wind{temperature, {0, 20}, 50};
+	PeriodPlot<Period> plot{os, period, temperature, rain, wind};
+	plot.plot(rollups);
+	return 0;
+    }
+}
+
+
+/**
+ * The main() of weather_month(1) and weather_year(1), which only
+ * differ in the Period they plot, and in their 'name'.
+ */
+template <class Period>
+int period_main(int argc, char ** argv, const char* name)
+{
+    const std::string prog = argv[0];
+    const std::string usage = std::string("usage: ")
+	+ prog + " [-p N] [-r] [-o image-file] file ...\n"
+	"       "
+	+ prog + " --help\n"
+	"       "
+	+ prog + " --version";
+    const char optstring[] = "p:ro:";
+    const struct option long_options[] = {
+	{"help", 0, 0, 'H'},
+	{"version", 0, 0, 'V'},
+	{0, 0, 0, 0}
+    };
+
+    std::cin.sync_with_stdio(false);
+    std::cout.sync_with_stdio(false);
+
+    std::string image_name;
+    Period when {std::time(nullptr)};
+    bool is_rollup = false;
+
+    int ch;
+    while((ch = getopt_long(argc, argv,
+			    optstring,
+			    &long_options[0], 0)) != -1) {
+	switch(ch) {
+	case 'p':
+	    char* end;
+	    for(unsigned long n = std::strtoul(optarg, &end, 10); n; n--) {
+		when = when.prev();
+	    }
+	    if(end==optarg || *end) {
+		std::cerr << "error: incorrect -p argument\n"
+			  << usage << '\n';
+		return 1;
+	    }
+	    break;
+	case 'r':
+	    is_rollup = true;
+	    break;
+	case 'o':
+	    image_name = optarg;
+	    break;
+	case 'H':
+	    std::cout << usage << '\n';
+	    return 0;
+	    break;
+	case 'V':
+	    std::cout << name << ", part of Weather 4.1\n"
+		      << "Copyright (c) 2026 Jrgen Grahn\n";
+	    return 0;
+	    break;
+	case ':':
+	case '?':
+	default:
+	    std::cerr << usage << '\n';
+	    return 1;
+	    break;
+	}
+    }
+
+    std::vector<std::string> files {argv+optind, argv+argc};
+    if(files.empty()) files.push_back("-");
+
+    std::vector<Rollup> rollups;
+    if(!read(rollups, when, is_rollup, files)) return 1;
+
+    if(image_name.empty()) return plot_period(when, rollups, std::cout);
+
+    std::ofstream os(image_name);
+    if(!os) {
+	std::cerr << "cannot open '" << image_name << "' for writing: "
+		  << std::strerror(errno) << '\n';
+	return 1;
+    }
+    return plot_period(when, rollups, os);
+}
+
+template int period_main<Month>(int, char**, const char*);
+template int period_main<Year>(int, char**, const char*);
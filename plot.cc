@@ -27,35 +27,55 @@
 #include "plot.h"
 
 #include "week.h"
+#include "period.h"
 #include "curves.h"
+#include "rollup.h"
 #include "direction.h"
 #include "path.h"
+#include "reckon.h"
+#include "groups.h"
 #include "files...h"
+#include "value.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <mutex>
 
 namespace {
 
     /**
-     * A floating-point number formatted with one decimal (because
-     * that's kind of a reasonable scale if the full plot is around
-     * 1000 wide).
+     * Attributes; floating-point numbers are formatted with one
+     * decimal (because that's kind of a reasonable scale if the full
+     * plot is around 1000 wide).
      */
-    std::string str(double val)
-    {
-	char buf[20];
-	std::snprintf(buf, sizeof buf, "%.1f", val);
-	return buf;
-    }
-
     xml::attr attr(const char* name, const char* val) { return {name, val}; }
     xml::attr attr(const char* name, const std::string& val) { return {name, val}; }
-    xml::attr attr(const char* name, int val) { return {name, std::to_string(val)}; }
-    xml::attr attr(const char* name, unsigned val) { return {name, std::to_string(val)}; }
-    xml::attr attr(const char* name, double val) { return {name, str(val)}; }
+    xml::attr attr(const char* name, int val) { return {name, val}; }
+    xml::attr attr(const char* name, unsigned val) { return {name, val}; }
+    xml::attr attr(const char* name, double val)
+    {
+	return xml::attr::formatted(name, [val] (char* buf, size_t size) {
+					return fixed1(buf, size, val);
+				    });
+    }
 
     xml::attr line(double x0, double y0, double x1, double y1)
     {
-	std::string s = str(x0) + ',' + str(y0) + ' ' + str(x1) + ',' + str(y1);
-	return {"points", s};
+	static_assert(xml::attr::capacity >= 4*15, "room for four numbers");
+	return xml::attr::formatted("points", [=] (char* buf, size_t) {
+					char* p = buf;
+					p += fixed1(p, 15, x0);
+					*p++ = ',';
+					p += fixed1(p, 15, y0);
+					*p++ = ' ';
+					p += fixed1(p, 15, x1);
+					*p++ = ',';
+					p += fixed1(p, 15, y1);
+					return size_t(p - buf);
+				    });
     }
 
     /**
@@ -83,10 +103,12 @@ namespace {
 
 	xml::attr viewbox(const Rect& r)
 	{
-	    std::ostringstream oss;
-	    oss << r.x << ' ' << r.y << ' '
-		<< r.dim.width + 40 << ' ' << r.dim.height;
-	    return {"viewBox", oss.str()};
+	    return xml::attr::formatted("viewBox", [&r] (char* buf, size_t size) {
+					    return size_t(std::snprintf(buf, size, "%u %u %u %u",
+									r.x, r.y,
+									r.dim.width + 40,
+									r.dim.height));
+					});
 	}
 
 	Rect total(const Area& a, const Area& b)
@@ -210,12 +232,12 @@ namespace {
 	    << attr("font-size", 12)
 	    << attr("fill", "black");
 
-	auto tick = [&xos] (unsigned y, const std::string& s) {
+	auto tick = [&xos] (unsigned y, const char* s) {
 	    const char deg[] = "\xc2\xb0";
 	    xos << xml::elem("tspan")
 	    << attr("x", 700)
 	    << attr("y", y)
-	    << s + deg
+	    << s << deg
 	    << xml::end;
 	};
 	tick( 44, "+20");
@@ -229,14 +251,16 @@ namespace {
     }
 
     /**
-     * The week rendered as text in an area.
+     * The week (or other period) rendered as text in an area.
      */
+    template <class Period>
     struct daterange {
-	Week week;
+	Period week;
 	Area a;
     };
 
-    xml::ostream& operator<< (xml::ostream& xos, const daterange& val)
+    template <class Period>
+    xml::ostream& operator<< (xml::ostream& xos, const daterange<Period>& val)
     {
 	xos << xml::elem("text")
 	    << attr("font-family", "serif")
@@ -254,6 +278,64 @@ namespace {
 }
 
 
+namespace {
+
+    /**
+     * The parts of a plot's background which don't depend on the
+     * week or the data, rendered once per Area configuration and
+     * then spliced into each plot: the colored rectangles before
+     * the daterange, the weekday borders after it, and then the
+     * temperature scale.
+     */
+    struct Background {
+	xml::fragment rects;
+	xml::fragment days;
+	xml::fragment temperature;
+    };
+
+    const Background& background(const Area& temp, const Area& wind)
+    {
+	using Key = std::array<long, 10>;
+	static std::mutex mutex;
+	static std::map<Key, Background> cache;
+
+	const Key key {temp.offset, temp.dim.width, temp.dim.height,
+		       temp.scale.min, temp.scale.max,
+		       wind.offset, wind.dim.width, wind.dim.height,
+		       wind.scale.min, wind.scale.max};
+
+	std::lock_guard<std::mutex> lock {mutex};
+	auto it = cache.find(key);
+	if(it!=cache.end()) return it->second;
+
+	Background& bg = cache[key];
+	std::ostringstream nil;
+	xml::ostream xos {nil};
+	xos << xml::elem("svg") << xml::attr("version", "1.1");
+
+	xos.record(bg.rects);
+	xos << rect::total(temp, wind)
+	    << rect::thaw(temp)
+	    << rect::freeze(temp)
+	    << rect::summer(temp);
+	xos.stop(bg.rects);
+
+	xos << daterange<Week>{Week{0}, temp};
+
+	xos.record(bg.days);
+	xos << days{temp, wind};
+	xos.stop(bg.days);
+
+	xos.record(bg.temperature);
+	xos << temperature{temp};
+	xos.stop(bg.temperature);
+
+	xos << xml::end;
+	return bg;
+    }
+}
+
+
 WeekPlot::WeekPlot(std::ostream& os,
 		   const Week& week,
 		   const Area& temp,
@@ -269,13 +351,11 @@ WeekPlot::WeekPlot(std::ostream& os,
 	<< viewbox(rect::total(temp, wind))
 	<< xml::attr("version", "1.1");
 
-    xos << rect::total(temp, wind)
-	<< rect::thaw(temp)
-	<< rect::freeze(temp)
-	<< rect::summer(temp)
-	<< daterange{week, temp}
-	<< days{temp, wind}
-	<< temperature{temp};
+    const Background& bg = background(temp, wind);
+    xos << bg.rects
+	<< daterange<Week>{week, temp}
+	<< bg.days
+	<< bg.temperature;
 }
 
 WeekPlot::~WeekPlot()
@@ -288,75 +368,152 @@ WeekPlot::~WeekPlot()
 
 namespace {
 
+    using Scratch = WeekPlot::Scratch;
+    using Thinning = WeekPlot::Thinning;
+
     /**
-     * Extract a certain selection from a curve and translate
-     * to plot coordinates.  If all samples are empty, return
-     * an empty curve rather than a flat line.
+     * The layers of a curve, in the order their y coordinates are
+     * stored in Scratch::Coordinates after the x coordinates.
      */
-    std::vector<std::pair<double, double>>
-    translate(const Area& area,
-	      const Curves::Curve& curve,
-	      Curves::Selection selection)
+    enum class Layer { rain = 1, temperature, gust, wind };
+
+    /**
+     * Translate a curve to plot coordinates, column by column: the x
+     * coordinate once, and then the y coordinate of each layer in its
+     * area.  Also notes which layers are not all zero.  The areas are
+     * all as wide as the plot.
+     */
+    void translate(Scratch::Coordinates& c,
+		   const Curves::Curve& curve,
+		   const Area& temp,
+		   const Area& rain,
+		   const Area& wind)
     {
-	std::vector<std::pair<double, double>> s;
-	bool flatline = true;
+	const size_t n = curve.size();
+	c.n = n;
+	c.v.resize(5 * n);
+	double* const x = c.v.data();
+	double* const yr = x + n;
+	double* const yt = yr + n;
+	double* const yg = yt + n;
+	double* const yw = yg + n;
+
+	const double* const t = curve.t.data();
+	const Value* const r = curve.rain_amount.data();
+	const Value* const ta = curve.temperature_air.data();
+	const Value* const g = curve.wind_force_max.data();
+	const Value* const w = curve.wind_force.data();
+
+	temp.xscale(t, t + n, x);
+	rain.yscale(r, r + n, yr);
+	temp.yscale(ta, ta + n, yt);
+	wind.yscale(g, g + n, yg);
+	wind.yscale(w, w + n, yw);
+
+	unsigned nonzero = 0;
+	for(size_t i = 0; i < n; i++) {
+	    nonzero |= (!r[i] ? 0 : 1u << unsigned(Layer::rain))
+		| (!ta[i] ? 0 : 1u << unsigned(Layer::temperature))
+		| (!g[i] ? 0 : 1u << unsigned(Layer::gust))
+		| (!w[i] ? 0 : 1u << unsigned(Layer::wind));
+	}
+	c.nonzero = nonzero;
+    }
 
-	for(const auto& sample : curve) {
-	    double x = area.xscale(sample.t);
-	    const Value val = sample.*selection;
-	    double y = area.yscale(val);
+    /**
+     * A layer of a translated curve, as points in scratch.s.  If all
+     * samples are empty, return an empty curve rather than a flat
+     * line.
+     */
+    std::vector<std::pair<double, double>>&
+    points(Scratch& scratch,
+	   const Scratch::Coordinates& c,
+	   Layer layer)
+    {
+	auto& s = scratch.s;
+	s.clear();
 
-	    s.push_back({x, y});
-	    if(val!=0) flatline = false;
-	}
+	const unsigned k = unsigned(layer);
+	if(!(c.nonzero & 1u << k)) return s;
 
-	if(flatline) s.clear();
+	const double* const x = c.v.data();
+	const double* const y = x + k * c.n;
+	s.reserve(c.n);
+	for(size_t i = 0; i < c.n; i++) s.push_back({x[i], y[i]});
 	return s;
     }
 
     /**
-     * Render a curve as a colored line, possibly with holes.
+     * Render a layer of a curve as a colored line, possibly with
+     * holes, and thinned out.
      */
-    void line(xml::ostream& xos, const Area& area,
-	      const Curves::Curve& curve,
-	      Curves::Selection selection,
+    void line(xml::ostream& xos, Scratch& scratch,
+	      const Area& area,
+	      const Scratch::Coordinates& c,
+	      Layer layer,
+	      const Thinning& thin,
 	      const char* color = "black")
     {
-	const auto s = translate(area, curve, selection);
+	auto& s = points(scratch, c, layer);
 	if(s.empty()) return;
 
 	const double hour = area.xscale(1.0/7/24);
+	if(thin.decimate) path::decimate(s);
+	if(thin.tolerance) path::simplify(s, thin.tolerance, hour);
 
 	xos << xml::elem("path")
 	    << attr("stroke", color)
 	    << attr("stroke-width", "1")
 	    << attr("stroke-linejoin", "round")
 	    << attr("fill", "none")
-	    << attr("d", path::line(hour, s))
+	    << attr("d", path::line(scratch.d, hour, s))
 	    << xml::end;
     }
 
     /**
-     * Render a curve as a semi-transparent blue area above the x
-     * axis, possibly with holes.
+     * Render the rain of a curve as a semi-transparent blue area
+     * above the x axis, possibly with holes.
      */
-    void water(xml::ostream& xos, const Area& area,
-	      const Curves::Curve& curve,
-	      Curves::Selection selection)
+    void water(xml::ostream& xos, Scratch& scratch,
+	       const Area& area,
+	       const Scratch::Coordinates& c,
+	       const Thinning& thin)
     {
-	const auto s = translate(area, curve, selection);
+	auto& s = points(scratch, c, Layer::rain);
 	if(s.empty()) return;
 
 	const double nil = area.yscale(0);
+	if(thin.decimate) path::decimate(s);
+	if(thin.tolerance) path::simplify_fill(s, thin.tolerance, nil);
 
 	xos << xml::elem("path")
 	    << attr("fill", "#4060c0")
 	    << attr("opacity", ".5")
-	    << attr("d", path::fill(nil, s))
+	    << attr("d", path::fill(scratch.d, scratch.fill, nil, s))
 	    << xml::end;
     }
 }
 
+/**
+ * Let plot() reduce the curves to at most four points per pixel
+ * column, for when there are many more samples than columns.  Off by
+ * default.
+ */
+void WeekPlot::decimate(bool enable)
+{
+    thinning.decimate = enable;
+}
+
+/**
+ * Let plot() drop points of curves which are within 'tolerance' of
+ * their neighbours, in plot units.  This is off (zero) by default;
+ * a tolerance below the .1 resolution of the output changes little.
+ */
+void WeekPlot::simplify(double tolerance)
+{
+    thinning.tolerance = tolerance;
+}
+
 /**
  * If the files (in weather(5) format) contains data for the
  * particular week, plot it.
@@ -365,11 +522,222 @@ void WeekPlot::plot(const Week& week, bool use_wind_direction,
 		    Files& files)
 {
     const Curves curves{week, files, std::cerr};
+    plot(use_wind_direction, curves);
+}
 
-    for(auto& curve: curves) water(xos, rain, curve, &Curves::Sample::rain_amount);
-    for(auto& curve: curves) line(xos, temp, curve, &Curves::Sample::temperature_air);
+/**
+ * Plot curves which have already been read for the week.  Each curve
+ * is translated to plot coordinates once, for all its layers, into
+ * buffers which are kept for the next plot.  Then the layers are
+ * drawn, one at a time for all curves.
+ */
+void WeekPlot::plot(bool use_wind_direction, const Curves& curves)
+{
+    auto& cc = scratch.curves;
+    size_t n = 0;
+    for(auto& curve: curves) {
+	if(cc.size()==n) cc.emplace_back();
+	translate(cc[n++], curve, temp, rain, wind);
+    }
+    const auto end = cc.begin() + n;
+
+    for(auto c = cc.begin(); c!=end; c++) water(xos, scratch, rain, *c, thinning);
+    for(auto c = cc.begin(); c!=end; c++) line(xos, scratch, temp, *c, Layer::temperature, thinning);
 
-    for(auto& curve: curves) line(xos, wind, curve, &Curves::Sample::wind_force_max, "#a0a0c0");
+    for(auto c = cc.begin(); c!=end; c++) line(xos, scratch, wind, *c, Layer::gust, thinning, "#a0a0c0");
     for(auto& curve: curves) if(use_wind_direction && direction(xos, wind, curve)) break;
-    for(auto& curve: curves) line(xos, wind, curve, &Curves::Sample::wind_force);
+    for(auto c = cc.begin(); c!=end; c++) line(xos, scratch, wind, *c, Layer::wind, thinning);
 }
+
+
+namespace {
+
+    /**
+     * Borders between the days of a month, or the months of a year.
+     */
+    struct borders {
+	const std::vector<double> v;
+	const Area a;
+	const Area b;
+    };
+
+    xml::ostream& operator<< (xml::ostream& xos, const borders& val)
+    {
+	for(double n : val.v) {
+	    double x = val.a.xscale(n);
+
+	    xos << xml::elem("polyline")
+		<< attr("stroke", "#808080") << attr("stroke-width", ".5")
+		<< attr("fill", "none")
+		<< line(x, 0, x, val.a.dim.height + val.b.dim.height)
+		<< xml::end;
+	}
+	return xos;
+    }
+
+    using Bucket = Rollup::Bucket;
+    using Points = path::Points;
+
+    /**
+     * Call f(x, bucket) for the hours (or days) of the rollup which
+     * are in the period, with x on its 0--1 scale.  An hour is placed
+     * at its middle, and so is a day.
+     */
+    template <class Period, class F>
+    void each(const Period& period, const Rollup& rollup, F f)
+    {
+	const auto& val = rollup.buckets();
+	auto it = val.lower_bound(period.first());
+	const auto end = val.upper_bound(period.last() + "~");
+	std::string ts;
+	for(; it!=end; it++) {
+	    const std::string& key = it->first;
+	    if(Period::hourly ? !Rollup::is_hour(key) : !Rollup::is_day(key)) continue;
+	    ts = key;
+	    ts += Period::hourly ? ":30:00" : "T12:00:00";
+	    f(period.scale(ts), it->second);
+	}
+    }
+
+    /**
+     * Like path::line(), but a filled band between 'lo' and 'hi',
+     * which have the same x coordinates: along 'hi' and back along
+     * 'lo'.
+     */
+    std::string& band(std::string& s, Points& scratch, double gap,
+		      const Points& lo, const Points& hi)
+    {
+	auto hole = [gap] (std::pair<double, double> a,
+			   std::pair<double, double> b) {
+			return a.first + gap < b.first;
+		    };
+	const auto rlo = lo.rbegin();
+	const size_t n = hi.size();
+	auto begin = std::begin(hi);
+	const auto end = std::end(hi);
+	s.clear();
+
+	while(begin != end) {
+	    auto a = pop_group(begin, end, hole);
+	    if(std::distance(a, begin) < 2) continue;
+
+	    scratch.assign(a, begin);
+	    scratch.insert(scratch.end(),
+			   rlo + (n - (begin - std::begin(hi))),
+			   rlo + (n - (a - std::begin(hi))));
+	    reckon(s, std::begin(scratch), std::end(scratch)) += '\n';
+	}
+	if(s.size()) s.pop_back();
+	return s;
+    }
+}
+
+
+template <class Period>
+PeriodPlot<Period>::PeriodPlot(std::ostream& os,
+			       const Period& period,
+			       const Area& temp,
+			       const Area& rain,
+			       const Area& wind)
+    : period{period},
+      xos{os},
+      temp{temp},
+      rain{rain},
+      wind{wind}
+{
+    xos << xml::elem("svg")
+	<< xml::attr("xmlns", "http://www.w3.org/2000/svg")
+	<< viewbox(rect::total(temp, wind))
+	<< xml::attr("version", "1.1");
+
+    const Background& bg = background(temp, wind);
+    xos << bg.rects
+	<< daterange<Period>{period, temp}
+	<< borders{period.borders(), temp, wind}
+	<< bg.temperature;
+}
+
+template <class Period>
+PeriodPlot<Period>::~PeriodPlot()
+{
+    xos << border{temp}
+	<< border{wind}
+	<< border{temp, wind}
+	<< xml::end;
+}
+
+/**
+ * Plot the rollups, one per location.  The rain is the mean in mm/h
+ * for a month, and the amount in mm for each day of a year.
+ */
+template <class Period>
+void PeriodPlot<Period>::plot(const std::vector<Rollup>& rollups)
+{
+    const double bucket = Period::hourly ? 3600 : 24 * 3600;
+    const double gap = 1.5 * temp.xscale(period.scale(std::time_t(bucket)) -
+					 period.scale(std::time_t(0)));
+    const double hours = Period::hourly ? 1 : 24;
+    auto& s = scratch.s;
+
+    for(const auto& rollup : rollups) {
+	s.clear();
+	each(period, rollup, [&] (double x, const Bucket& b) {
+				 s.push_back({rain.xscale(x),
+					      rain.yscale(b.rain_per_hour() * hours)});
+			     });
+	path::fill(scratch.d, scratch.fill, rain.yscale(0), s);
+	if(scratch.d.empty()) continue;
+
+	xos << xml::elem("path")
+	    << attr("fill", "#4060c0")
+	    << attr("opacity", ".5")
+	    << attr("d", scratch.d)
+	    << xml::end;
+    }
+
+    for(const auto& rollup : rollups) {
+	Points lo;
+	Points hi;
+	s.clear();
+	each(period, rollup, [&] (double x, const Bucket& b) {
+				 if(!b.tn) return;
+				 x = temp.xscale(x);
+				 s.push_back({x, temp.yscale(b.mean())});
+				 lo.push_back({x, temp.yscale(b.tmin)});
+				 hi.push_back({x, temp.yscale(b.tmax)});
+			     });
+	if(s.empty()) continue;
+
+	xos << xml::elem("path")
+	    << attr("fill", "black")
+	    << attr("opacity", ".15")
+	    << attr("d", band(scratch.d, scratch.fill, gap, lo, hi))
+	    << xml::end;
+	xos << xml::elem("path")
+	    << attr("stroke", "black")
+	    << attr("stroke-width", "1")
+	    << attr("stroke-linejoin", "round")
+	    << attr("fill", "none")
+	    << attr("d", path::line(scratch.d, gap, s))
+	    << xml::end;
+    }
+
+    for(const auto& rollup : rollups) {
+	s.clear();
+	each(period, rollup, [&] (double x, const Bucket& b) {
+				 s.push_back({wind.xscale(x), wind.yscale(b.gust)});
+			     });
+	if(s.empty()) continue;
+
+	xos << xml::elem("path")
+	    << attr("stroke", "black")
+	    << attr("stroke-width", "1")
+	    << attr("stroke-linejoin", "round")
+	    << attr("fill", "none")
+	    << attr("d", path::line(scratch.d, gap, s))
+	    << xml::end;
+    }
+}
+
+template class PeriodPlot<Month>;
+template class PeriodPlot<Year>;
@@ -29,12 +29,18 @@
 #define WEATHER_PLOT_H
 
 #include "area.h"
+#include "period.h"
 
 #include "xml.h"
 #include <iosfwd>
+#include <vector>
+#include <string>
+#include <utility>
 
 class Week;
 class Files;
+class Curves;
+class Rollup;
 
 
 /**
@@ -68,12 +74,75 @@ public:
 
     void plot(const Week& week, bool use_wind_direction,
 	      Files& files);
+    void plot(bool use_wind_direction, const Curves& curves);
+
+    void decimate(bool enable);
+    void simplify(double tolerance);
+
+    /**
+     * How plot() thins out curves before drawing them.
+     */
+    struct Thinning {
+	bool decimate = false;
+	double tolerance = 0;
+    };
+
+    /**
+     * Buffers reused from curve to curve, so that plotting doesn't
+     * allocate memory once they have grown to size.
+     */
+    struct Scratch {
+	/* A curve in plot coordinates: x, then y for each layer.
+	 */
+	struct Coordinates {
+	    std::vector<double> v;
+	    size_t n = 0;
+	    unsigned nonzero = 0;
+	};
+	std::vector<Coordinates> curves;
+	std::vector<std::pair<double, double>> s;
+	std::vector<std::pair<double, double>> fill;
+	std::string d;
+    };
 
 private:
+    Scratch scratch;
+    Thinning thinning;
     xml::ostream xos;
     Area temp;
     Area rain;
     Area wind;
 };
 
+
+/**
+ * Like WeekPlot, but for a longer Period (Month or Year), and from
+ * Rollups rather than Curves: hourly ones for a month, daily ones for
+ * a year.  Each rollup is drawn as the range of the temperature with
+ * the mean in it, the rain and the max wind gust.
+ */
+template <class Period>
+class PeriodPlot {
+public:
+    PeriodPlot(std::ostream& os,
+	       const Period& period,
+	       const Area& temp,
+	       const Area& rain,
+	       const Area& wind);
+    ~PeriodPlot();
+
+    void plot(const std::vector<Rollup>& rollups);
+
+private:
+    Period period;
+    WeekPlot::Scratch scratch;
+    xml::ostream xos;
+    Area temp;
+    Area rain;
+    Area wind;
+};
+
+using MonthPlot = PeriodPlot<Month>;
+using YearPlot = PeriodPlot<Year>;
+
 #endif
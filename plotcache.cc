@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "plotcache.h"
+
+PlotCache::PlotCache(size_t limit)
+    : limit{limit}
+{}
+
+/**
+ * The entry for a station's week, or nullptr.  Finding it makes it
+ * the most recently used.
+ */
+PlotCache::Entry* PlotCache::find(const Key& key)
+{
+    auto it = index.find(key);
+    if(it==index.end()) return nullptr;
+    lru.splice(lru.begin(), lru, it->second);
+    return &it->second->second;
+}
+
+/**
+ * Add an entry with no plots yet, replacing any old one.  It's never
+ * evicted while it's the most recently used one, so the reference
+ * stays valid until the next insert().
+ */
+PlotCache::Entry& PlotCache::insert(const Key& key, Curves&& curves)
+{
+    invalidate(key.station, key.monday);
+    lru.emplace_front(key, Entry{});
+    index[key] = lru.begin();
+
+    Entry& entry = lru.front().second;
+    entry.curves = std::move(curves);
+    entry.size = size(entry.curves);
+    total += entry.size;
+    evict();
+    return entry;
+}
+
+/**
+ * Add a plot in some format to an entry.
+ */
+void PlotCache::add(Entry& entry, const std::string& format, const Plot& plot)
+{
+    Plot& p = entry.plots[format];
+    if(p) {
+	entry.size -= p->size();
+	total -= p->size();
+    }
+    p = plot;
+    entry.size += p->size();
+    total += p->size();
+    evict();
+}
+
+/**
+ * Drop a station's week, if it's in the cache.
+ */
+void PlotCache::invalidate(unsigned station, const std::string& monday)
+{
+    auto it = index.find({station, monday});
+    if(it==index.end()) return;
+    total -= it->second->second.size;
+    lru.erase(it->second);
+    index.erase(it);
+}
+
+/**
+ * Drop all weeks of a station.
+ */
+void PlotCache::invalidate(unsigned station)
+{
+    auto it = index.lower_bound({station, ""});
+    while(it!=index.end() && it->first.station==station) {
+	total -= it->second->second.size;
+	lru.erase(it->second);
+	it = index.erase(it);
+    }
+}
+
+/**
+ * Drop the least recently used entries until the cache fits in
+ * its limit, or only the most recently used is left.
+ */
+void PlotCache::evict()
+{
+    while(total > limit && lru.size() > 1) {
+	auto& last = lru.back();
+	total -= last.second.size;
+	index.erase(last.first);
+	lru.pop_back();
+    }
+}
+
+/**
+ * The size of the columns of all curves.
+ */
+size_t PlotCache::size(const Curves& curves)
+{
+    const size_t sample = sizeof(std::time_t) + sizeof(double) + 5 * sizeof(Value);
+    size_t n = 0;
+    for(const auto& curve : curves) n += curve.size() * sample;
+    return n;
+}
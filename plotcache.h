@@ -0,0 +1,96 @@
+/* -*- c++ -*-
+ *
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WEATHER_PLOTCACHE_H
+#define WEATHER_PLOTCACHE_H
+
+#include "curves.h"
+
+#include <string>
+#include <map>
+#include <list>
+#include <memory>
+#include <cstddef>
+
+/**
+ * An in-memory cache of the Curves of recently plotted weeks, and the
+ * plots rendered from them, for a server which plots on demand.  It's
+ * keyed by station (an index) and week (its Monday); an entry holds
+ * the Curves and the plots in each format that have been asked for.
+ *
+ * The cache is limited in size, counted as the bytes of the Curves'
+ * columns and of the plots.  When it grows larger than that, the
+ * least recently used entries are dropped.  Entries are also dropped
+ * when the data they came from changes.
+ *
+ * The plots are shared pointers, so that they can be written to
+ * clients after the entry is gone.
+ */
+class PlotCache {
+public:
+    explicit PlotCache(size_t limit);
+
+    struct Key {
+	unsigned station;
+	std::string monday;
+	bool operator< (const Key& other) const {
+	    if(station!=other.station) return station < other.station;
+	    return monday < other.monday;
+	}
+    };
+
+    using Plot = std::shared_ptr<const std::string>;
+
+    struct Entry {
+	Curves curves;
+	std::map<std::string, Plot> plots;
+	size_t size = 0;
+    };
+
+    Entry* find(const Key& key);
+    Entry& insert(const Key& key, Curves&& curves);
+    void add(Entry& entry, const std::string& format, const Plot& plot);
+
+    void invalidate(unsigned station, const std::string& monday);
+    void invalidate(unsigned station);
+
+    size_t size() const { return total; }
+    size_t entries() const { return index.size(); }
+
+    static size_t size(const Curves& curves);
+
+private:
+    void evict();
+
+    using Lru = std::list<std::pair<Key, Entry>>;
+    Lru lru;
+    std::map<Key, Lru::iterator> index;
+    const size_t limit;
+    size_t total = 0;
+};
+
+#endif
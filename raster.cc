@@ -0,0 +1,619 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "raster.h"
+
+#include "font.h"
+
+#include <map>
+#include <set>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using raster::Canvas;
+using raster::Color;
+using raster::Point;
+using raster::Polygon;
+using raster::Polygons;
+
+namespace {
+
+    using Attributes = std::map<std::string, std::string>;
+
+    /**
+     * An element start, an element end or some text.
+     */
+    struct Token {
+	enum Kind { open, close, text };
+	Kind kind = text;
+	std::string name;
+	Attributes attrs;
+	bool empty = false;
+    };
+
+    void utf8(std::string& s, unsigned long c)
+    {
+	if(c < 0x80) {
+	    s += char(c);
+	}
+	else if(c < 0x800) {
+	    s += char(0xc0 | c >> 6);
+	    s += char(0x80 | (c & 0x3f));
+	}
+	else if(c < 0x10000) {
+	    s += char(0xe0 | c >> 12);
+	    s += char(0x80 | (c >> 6 & 0x3f));
+	    s += char(0x80 | (c & 0x3f));
+	}
+	else {
+	    s += char(0xf0 | c >> 18);
+	    s += char(0x80 | (c >> 12 & 0x3f));
+	    s += char(0x80 | (c >> 6 & 0x3f));
+	    s += char(0x80 | (c & 0x3f));
+	}
+    }
+
+    /**
+     * The XML text or attribute value [a, b), with entity and
+     * character references replaced.
+     */
+    std::string unescape(const char* a, const char* const b)
+    {
+	std::string s;
+	while(a!=b) {
+	    const char* semi = a;
+	    if(*a=='&') semi = std::find(a, b, ';');
+	    if(semi==a || semi==b) {
+		s += *a++;
+		continue;
+	    }
+	    const std::string ref {a + 1, semi};
+	    if(ref=="amp") s += '&';
+	    else if(ref=="lt") s += '<';
+	    else if(ref=="gt") s += '>';
+	    else if(ref=="quot") s += '"';
+	    else if(ref=="apos") s += '\'';
+	    else if(ref[0]=='#' && ref[1]=='x') utf8(s, std::strtoul(ref.c_str() + 2, nullptr, 16));
+	    else if(ref[0]=='#') utf8(s, std::strtoul(ref.c_str() + 1, nullptr, 10));
+	    a = semi + 1;
+	}
+	return s;
+    }
+
+    bool space(char c)
+    {
+	return c==' ' || c=='\t' || c=='\n' || c=='\r';
+    }
+
+    /**
+     * The next token in 's' at 'pos', skipping the XML declaration,
+     * comments and such.  Returns false at the end, and if the XML
+     * isn't well-formed enough to make sense of.
+     */
+    bool next(const std::string& s, size_t& pos, Token& t)
+    {
+	const char* const base = s.data();
+	const size_t size = s.size();
+
+	while(pos < size) {
+	    if(s[pos]!='<') {
+		size_t end = s.find('<', pos);
+		if(end==std::string::npos) end = size;
+		t.kind = Token::text;
+		t.name = unescape(base + pos, base + end);
+		pos = end;
+		return true;
+	    }
+	    if(s.compare(pos, 4, "<!--")==0) {
+		pos = s.find("-->", pos);
+		if(pos==std::string::npos) return false;
+		pos += 3;
+		continue;
+	    }
+	    if(s.compare(pos, 2, "<?")==0 || s.compare(pos, 2, "<!")==0) {
+		pos = s.find('>', pos);
+		if(pos==std::string::npos) return false;
+		pos++;
+		continue;
+	    }
+	    break;
+	}
+	if(pos >= size) return false;
+
+	pos++;
+	t.kind = Token::open;
+	t.attrs.clear();
+	t.empty = false;
+	if(s[pos]=='/') {
+	    t.kind = Token::close;
+	    pos++;
+	}
+
+	auto name = [&] {
+			const size_t a = pos;
+			while(pos < size && !space(s[pos]) &&
+			      s[pos]!='/' && s[pos]!='>' && s[pos]!='=') pos++;
+			return s.substr(a, pos - a);
+		    };
+	auto skip = [&] { while(pos < size && space(s[pos])) pos++; };
+
+	t.name = name();
+	while(true) {
+	    skip();
+	    if(pos >= size) return false;
+	    if(s[pos]=='>') break;
+	    if(s[pos]=='/') {
+		t.empty = true;
+		pos++;
+		continue;
+	    }
+
+	    const std::string key = name();
+	    skip();
+	    if(pos >= size || s[pos]!='=') return false;
+	    pos++;
+	    skip();
+	    if(pos >= size || (s[pos]!='\'' && s[pos]!='"')) return false;
+	    const size_t end = s.find(s[pos], pos + 1);
+	    if(end==std::string::npos) return false;
+	    t.attrs[key] = unescape(base + pos + 1, base + end);
+	    pos = end + 1;
+	}
+	pos++;
+	return true;
+    }
+
+    /**
+     * Read a number from 'p', after any whitespace and commas, and
+     * step past it.
+     */
+    bool number(const char*& p, double& val)
+    {
+	while(space(*p) || *p==',') p++;
+	char* end;
+	val = std::strtod(p, &end);
+	if(end==p) return false;
+	p = end;
+	return true;
+    }
+
+    double number(const Attributes& attrs, const char* name, double val = 0)
+    {
+	auto it = attrs.find(name);
+	if(it==attrs.end()) return val;
+	const char* p = it->second.c_str();
+	number(p, val);
+	return val;
+    }
+
+    /**
+     * Parse a color: "none", #rgb, #rrggbb or one of a few names.
+     * Sets 'on' to whether there's any color at all.
+     */
+    void color(const std::string& s, bool& on, Color& c)
+    {
+	on = s!="none";
+	c = {0, 0, 0};
+	if(s=="white") c = {255, 255, 255};
+	if(s.size()==7 && s[0]=='#') {
+	    const unsigned long n = std::strtoul(s.c_str() + 1, nullptr, 16);
+	    c = {(unsigned char)(n >> 16), (unsigned char)(n >> 8), (unsigned char)n};
+	}
+	if(s.size()==4 && s[0]=='#') {
+	    const unsigned long n = std::strtoul(s.c_str() + 1, nullptr, 16);
+	    c = {(unsigned char)(0x11 * (n >> 8 & 15)),
+		 (unsigned char)(0x11 * (n >> 4 & 15)),
+		 (unsigned char)(0x11 * (n & 15))};
+	}
+    }
+
+    enum class Anchor { start, middle, end };
+
+    /**
+     * The properties of an element which matter to us, as inherited
+     * from its parents, except the opacity which accumulates.
+     */
+    struct Style {
+	bool text = false;
+	bool fill = true;
+	Color fill_color {0, 0, 0};
+	bool stroke = false;
+	Color stroke_color {0, 0, 0};
+	double stroke_width = 1;
+	double opacity = 1;
+	double font_size = 16;
+	bool bold = false;
+	bool italic = false;
+	Anchor anchor = Anchor::start;
+    };
+
+    /**
+     * Attributes which are used in drawing the element rather than
+     * styling it, or which don't matter in a raster.  (The joins of
+     * strokes are always round.)
+     */
+    bool is_geometry(const std::string& key)
+    {
+	static const std::set<std::string> keys {
+	    "x", "y", "width", "height",
+	    "x1", "y1", "x2", "y2",
+	    "points", "d", "viewBox",
+	    "xmlns", "version", "font-family", "stroke-linejoin",
+	};
+	return keys.count(key);
+    }
+
+    bool is_element(const std::string& name)
+    {
+	static const std::set<std::string> names {
+	    "svg", "g", "rect", "line", "polyline", "polygon", "path",
+	    "text", "tspan",
+	};
+	return names.count(name);
+    }
+
+    void apply(Style& st, const Token& t, std::set<std::string>& ignored)
+    {
+	st.text = t.name=="text" || t.name=="tspan";
+	for(const auto& kv : t.attrs) {
+	    const std::string& key = kv.first;
+	    const std::string& val = kv.second;
+	    if(key=="fill") color(val, st.fill, st.fill_color);
+	    else if(key=="stroke") color(val, st.stroke, st.stroke_color);
+	    else if(key=="stroke-width") st.stroke_width = number(t.attrs, "stroke-width");
+	    else if(key=="opacity") st.opacity *= number(t.attrs, "opacity", 1);
+	    else if(key=="font-size") st.font_size = number(t.attrs, "font-size");
+	    else if(key=="font-weight") st.bold = val=="bold" || val=="bolder" || std::atoi(val.c_str()) >= 600;
+	    else if(key=="font-style") st.italic = val!="normal";
+	    else if(key=="text-anchor") {
+		st.anchor = val=="middle" ? Anchor::middle :
+		            val=="end" ? Anchor::end : Anchor::start;
+	    }
+	    else if(!is_geometry(key)) ignored.insert(key + '=');
+	}
+    }
+
+    /**
+     * The subpaths of an SVG path, from the absolute and relative
+     * moveto, lineto and closepath commands.  Curves aren't
+     * supported; the path ends where one appears, or where the path
+     * is malformed, and that command is added to 'ignored'.
+     */
+    Polygons path(const std::string& d, std::set<std::string>& ignored)
+    {
+	Polygons v;
+	const char* p = d.c_str();
+	char cmd = 0;
+	Point cur {0, 0};
+	Point start {0, 0};
+	bool closed = false;
+
+	while(true) {
+	    while(space(*p) || *p==',') p++;
+	    if(!*p) break;
+	    if(std::isalpha((unsigned char)*p)) cmd = *p++;
+	    if(cmd=='Z' || cmd=='z') {
+		if(v.size()) v.back().push_back(start);
+		cur = start;
+		closed = true;
+		cmd = 0;
+		continue;
+	    }
+
+	    auto stop = [&] {
+			    ignored.insert(std::string("d=") + (cmd ? cmd : *p));
+			    return v;
+			};
+	    double a, b = 0;
+	    if(!number(p, a)) return stop();
+	    const bool pair = cmd!='H' && cmd!='h' && cmd!='V' && cmd!='v';
+	    if(pair && !number(p, b)) return stop();
+
+	    switch(cmd) {
+	    case 'M': cur = {a, b}; break;
+	    case 'm': cur = {cur.first + a, cur.second + b}; break;
+	    case 'L': cur = {a, b}; break;
+	    case 'l': cur = {cur.first + a, cur.second + b}; break;
+	    case 'H': cur.first = a; break;
+	    case 'h': cur.first += a; break;
+	    case 'V': cur.second = a; break;
+	    case 'v': cur.second += a; break;
+	    default: return stop();
+	    }
+
+	    if(cmd=='M' || cmd=='m') {
+		v.emplace_back();
+		start = cur;
+		cmd = cmd=='M' ? 'L' : 'l';
+	    }
+	    else if(closed || v.empty()) {
+		v.push_back({start});
+	    }
+	    closed = false;
+	    v.back().push_back(cur);
+	}
+	return v;
+    }
+
+    Polygon points(const std::string& s)
+    {
+	Polygon v;
+	const char* p = s.c_str();
+	double x, y;
+	while(number(p, x) && number(p, y)) v.push_back({x, y});
+	return v;
+    }
+
+    /**
+     * Decode UTF-8, with anything broken as U+FFFD.
+     */
+    std::vector<unsigned> decode(const std::string& s)
+    {
+	std::vector<unsigned> v;
+	for(size_t i = 0; i < s.size(); ) {
+	    const unsigned char c = s[i++];
+	    unsigned n = c < 0x80 ? 0 : c < 0xe0 ? 1 : c < 0xf0 ? 2 : 3;
+	    unsigned cp = n ? c & (0x3f >> n) : c;
+	    if(c >= 0x80 && c < 0xc0) n = 0, cp = 0xfffd;
+	    while(n--) {
+		if(i==s.size() || (s[i] & 0xc0)!=0x80) {
+		    cp = 0xfffd;
+		    break;
+		}
+		cp = cp << 6 | (s[i++] & 0x3f);
+	    }
+	    v.push_back(cp);
+	}
+	return v;
+    }
+
+    /**
+     * Draws the elements of a document onto a Canvas, given the
+     * top left corner of the viewBox.
+     */
+    class Renderer {
+    public:
+	Renderer(Canvas& canvas, double x, double y,
+		 std::set<std::string>& ignored)
+	    : canvas(canvas),
+	      origin{x, y},
+	      ignored(ignored)
+	{}
+
+	void open(const Token& t);
+	void close();
+	void text(std::string s);
+
+    private:
+	void draw(Polygons v, bool closed);
+	Point at(double x, double y) const {
+	    return {x - origin.first, y - origin.second};
+	}
+
+	Canvas& canvas;
+	const Point origin;
+	std::set<std::string>& ignored;
+	std::vector<Style> stack;
+	Point pen;
+    };
+
+    void Renderer::open(const Token& t)
+    {
+	stack.push_back(stack.empty() ? Style{} : stack.back());
+	Style& st = stack.back();
+	apply(st, t, ignored);
+	if(!is_element(t.name)) ignored.insert('<' + t.name + '>');
+	const Attributes& a = t.attrs;
+
+	if(st.text) {
+	    pen = at(number(a, "x", pen.first + origin.first),
+		     number(a, "y", pen.second + origin.second));
+	}
+	else if(t.name=="rect") {
+	    const double x = number(a, "x");
+	    const double y = number(a, "y");
+	    const double w = number(a, "width");
+	    const double h = number(a, "height");
+	    draw({{at(x, y), at(x + w, y), at(x + w, y + h), at(x, y + h)}}, true);
+	}
+	else if(t.name=="line") {
+	    st.fill = false;
+	    draw({{at(number(a, "x1"), number(a, "y1")),
+		   at(number(a, "x2"), number(a, "y2"))}}, false);
+	}
+	else if(t.name=="polyline" || t.name=="polygon") {
+	    auto it = a.find("points");
+	    if(it!=a.end()) {
+		Polygon v = points(it->second);
+		for(auto& p : v) p = at(p.first, p.second);
+		draw({v}, t.name=="polygon");
+	    }
+	}
+	else if(t.name=="path") {
+	    auto it = a.find("d");
+	    if(it!=a.end()) {
+		Polygons v = path(it->second, ignored);
+		for(auto& poly : v) {
+		    for(auto& p : poly) p = at(p.first, p.second);
+		}
+		draw(v, false);
+	    }
+	}
+
+	if(t.empty) close();
+    }
+
+    void Renderer::close()
+    {
+	if(stack.size()) stack.pop_back();
+    }
+
+    /**
+     * Fill and stroke the shape as the current style says.
+     */
+    void Renderer::draw(Polygons v, bool closed)
+    {
+	const Style& st = stack.back();
+	if(st.fill) {
+	    canvas.fill(v);
+	    canvas.paint(st.fill_color, st.opacity);
+	}
+	if(st.stroke && st.stroke_width > 0) {
+	    if(closed) {
+		for(auto& p : v) if(p.size()) p.push_back(p.front());
+	    }
+	    canvas.stroke(v, st.stroke_width);
+	    canvas.paint(st.stroke_color, st.opacity);
+	}
+    }
+
+    /**
+     * Render text at the pen position, in the bitmap font scaled so
+     * that its seven pixels are 70% of the font size.  Bold is done
+     * by smearing each pixel to the right, and italic by slanting.
+     * Whitespace is handled like SVG does by default.
+     */
+    void Renderer::text(std::string s)
+    {
+	if(stack.empty() || !stack.back().text) return;
+	const Style& st = stack.back();
+
+	s.erase(std::remove(begin(s), end(s), '\n'), end(s));
+	std::replace(begin(s), end(s), '\t', ' ');
+	const size_t a = s.find_first_not_of(' ');
+	if(a==std::string::npos) return;
+	s = s.substr(a, s.find_last_not_of(' ') + 1 - a);
+	s.erase(std::unique(begin(s), end(s),
+			    [] (char a, char b) { return a==' ' && b==' '; }),
+		end(s));
+
+	const std::vector<unsigned> cps = decode(s);
+	const double u = st.font_size / 10;
+	const double advance = (font::width + 1) * u;
+	const double width = cps.size() * advance - u;
+	double x = pen.first;
+	if(st.anchor==Anchor::middle) x -= width / 2;
+	if(st.anchor==Anchor::end) x -= width;
+	const double y = pen.second;
+
+	const double bold = st.bold ? u / 2 : 0;
+	const double slant = st.italic ? .2 : 0;
+	auto slanted = [y, slant] (double x, double yy) {
+			   return Point {x + (y - yy) * slant, yy};
+		       };
+
+	Polygons v;
+	for(unsigned cp : cps) {
+	    const unsigned char* const g = font::glyph(cp);
+	    for(unsigned row = 0; g && row < font::height; row++) {
+		const double top = y - (font::height - row) * u;
+		const double bottom = top + u;
+		unsigned col = 0;
+		while(col < font::width) {
+		    if(!(g[col] >> row & 1)) {
+			col++;
+			continue;
+		    }
+		    const unsigned first = col;
+		    while(col < font::width && g[col] >> row & 1) col++;
+		    const double x0 = x + first * u;
+		    const double x1 = x + col * u + bold;
+		    v.push_back({slanted(x0, top), slanted(x1, top),
+				 slanted(x1, bottom), slanted(x0, bottom)});
+		}
+	    }
+	    x += advance;
+	}
+	pen.first = x;
+
+	if(st.fill) {
+	    canvas.fill(v);
+	    canvas.paint(st.fill_color, st.opacity);
+	}
+    }
+}
+
+
+/**
+ * Rasterize an SVG document onto a white Canvas the size of its
+ * viewBox (or width and height), one pixel per unit.
+ *
+ * Only the subset of SVG the plots use is supported: <rect>,
+ * <line>, <polyline>, <polygon> and <path> with straight lines, and
+ * <text> and <tspan> in a built-in bitmap font, painted with fill,
+ * stroke, stroke-width and opacity.  Anything else is ignored.  If
+ * there's no usable <svg> element, the Canvas is empty.
+ */
+Canvas raster::rasterize(const std::string& svg)
+{
+    std::set<std::string> ignored;
+    return rasterize(svg, ignored);
+}
+
+/**
+ * Like rasterize(svg), but also note in 'ignored' what was ignored:
+ * elements as "<name>", attributes as "name=" and path commands as
+ * "d=C".  This is for finding out if the plots have started using
+ * SVG features which aren't supported here.
+ */
+Canvas raster::rasterize(const std::string& svg, std::set<std::string>& ignored)
+{
+    size_t pos = 0;
+    Token t;
+    bool found = false;
+    while(!found && next(svg, pos, t)) found = t.kind==Token::open;
+    if(!found || t.name!="svg") return {};
+
+    double x = 0;
+    double y = 0;
+    double width = number(t.attrs, "width");
+    double height = number(t.attrs, "height");
+    auto it = t.attrs.find("viewBox");
+    if(it!=t.attrs.end()) {
+	const char* p = it->second.c_str();
+	if(!(number(p, x) && number(p, y) &&
+	     number(p, width) && number(p, height))) return {};
+    }
+    const double max = 1 << 14;
+    if(!(width >= 1 && width <= max && height >= 1 && height <= max)) return {};
+
+    Canvas canvas {unsigned(std::ceil(width)), unsigned(std::ceil(height)),
+		   {255, 255, 255}};
+    Renderer renderer {canvas, x, y, ignored};
+    renderer.open(t);
+    while(next(svg, pos, t)) {
+	switch(t.kind) {
+	case Token::open: renderer.open(t); break;
+	case Token::close: renderer.close(); break;
+	case Token::text: renderer.text(t.name); break;
+	}
+    }
+    return canvas;
+}
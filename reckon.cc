@@ -40,13 +40,14 @@ Value Reckon::moveto(double n)
     return delta;
 }
 
-PathFormat::PathFormat(std::ostream& os,
+PathFormat::PathFormat(std::string& s,
 		       const std::pair<double, double>& xy)
-    : os{os}
+    : s{s}
 {
     const double x = xy.first;
     const double y = xy.second;
-    os << cmd << rx.start(x) << ' ' << ry.start(y) << ' ';
+    put(cmd, rx.start(x), ry.start(y));
+    s += ' ';
     cmd = 'l';
 }
 
@@ -59,6 +60,20 @@ void PathFormat::add(const std::pair<double, double>& xy)
     }
     const double x = xy.first;
     const double y = xy.second;
-    os << cmd << rx.moveto(x) << ' ' << ry.moveto(y);
+    put(cmd, rx.moveto(x), ry.moveto(y));
     cmd = ' ';
 }
+
+/**
+ * Append "c x y".
+ */
+void PathFormat::put(char c, Value x, Value y)
+{
+    char buf[50];
+    char* p = buf;
+    *p++ = c;
+    p += x.format(p, 20);
+    *p++ = ' ';
+    p += y.format(p, 20);
+    s.append(buf, p);
+}
@@ -30,7 +30,8 @@
 
 #include "value.h"
 
-#include <iostream>
+#include <string>
+#include <utility>
 
 /**
  * Some kind of dead reckoning: given a sequence of numbers a, b, c,
@@ -61,12 +62,14 @@ private:
 
 class PathFormat {
 public:
-    PathFormat(std::ostream& os,
+    PathFormat(std::string& s,
 	       const std::pair<double, double>& xy);
     void add(const std::pair<double, double>& xy);
 
 private:
-    std::ostream& os;
+    void put(char c, Value x, Value y);
+
+    std::string& s;
     char cmd = 'M';
     unsigned short n = 0;
     Reckon rx;
@@ -76,21 +79,21 @@ private:
 
 /**
  * Given a sequence of (x, y) coordinates, apply class Reckon to
- * generate a SVG <path d=...> attribute string with relative
- * movements.
+ * append a SVG <path d=...> attribute string with relative
+ * movements to a string.
  *
  * Undefined results if the sequence is empty.
  */
 template <class Iter>
-std::ostream& reckon(std::ostream& os, Iter begin, const Iter end)
+std::string& reckon(std::string& s, Iter begin, const Iter end)
 {
-    PathFormat pf(os, *begin++);
+    PathFormat pf(s, *begin++);
 
     while(begin != end) {
 	pf.add(*begin++);
     }
 
-    return os;
+    return s;
 }
 
 #endif
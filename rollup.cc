@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "rollup.h"
+
+#include "files...h"
+#include "field.h"
+#include "timestamp.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cerrno>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+using Bucket = Rollup::Bucket;
+using Observation = Rollup::Observation;
+
+namespace {
+
+    std::ostream& put(std::ostream& os,
+		      const std::string& key, const Bucket& b)
+    {
+	return os << key << ' ' << b.last << ' '
+		  << b.samples << ' ' << Value{b.rain} << ' '
+		  << b.tn << ' ' << b.tmin << ' ' << b.tmax << ' '
+		  << Value{b.tsum} << ' '
+		  << b.gust << '\n';
+    }
+
+    bool parse(const std::string& s, std::string& key, Bucket& b)
+    {
+	std::istringstream iss{s};
+	double rain, tmin, tmax, tsum, gust;
+	iss >> key >> b.last
+	    >> b.samples >> rain
+	    >> b.tn >> tmin >> tmax >> tsum
+	    >> gust;
+	if(!iss) return false;
+	b.rain = rain;
+	b.tmin = tmin;
+	b.tmax = tmax;
+	b.tsum = tsum;
+	b.gust = gust;
+	if(!timestamp::parse(b.last, b.epoch)) return false;
+	return Rollup::is_hour(key) || Rollup::is_day(key);
+    }
+
+    bool by_time(const Observation& a, const Observation& b)
+    {
+	return a.epoch < b.epoch;
+    }
+}
+
+
+void Bucket::add(const Observation& obs)
+{
+    last = obs.time;
+    epoch = obs.epoch;
+    samples++;
+    rain += obs.rain.value();
+    if(gust < obs.gust) gust = obs.gust;
+    if(obs.has_temperature) {
+	const Value t = obs.temperature;
+	if(!tn || t < tmin) tmin = t;
+	if(!tn || tmax < t) tmax = t;
+	tsum += t.value();
+	tn++;
+    }
+}
+
+
+/**
+ * Rebuild the rollup from the raw weather(5) data.  The samples may
+ * be out of order; if there are duplicates, the first one is used.
+ * Samples with a date which cannot be parsed are ignored.
+ */
+Rollup::Rollup(Files& files)
+    : Rollup(files, "", "~")
+{}
+
+/**
+ * Like Rollup(files), but only for the samples from the days
+ * 'first' to 'last', e.g. "2018-10-01" and "2018-10-31".  Since only
+ * those are kept in memory, this is a way to aggregate a month or a
+ * year on the fly from years of data.
+ */
+Rollup::Rollup(Files& files, const std::string& first, const std::string& last)
+{
+    std::vector<Observation> v;
+    bool skip = true;
+
+    const char* a;
+    const char* b;
+    while(files.getline(a, b)) {
+	field::Field f;
+	if(field::split(f, a, b) != field::Kind::field) continue;
+
+	if(field::is(f, "date")) {
+	    const std::string day(f.val, std::min<size_t>(f.val_end - f.val, 10));
+	    std::time_t t;
+	    skip = day < first || last < day || !timestamp::parse(f.val, f.val_end, t);
+	    if(skip) continue;
+	    v.push_back({});
+	    v.back().time.assign(f.val, f.val_end);
+	    v.back().epoch = t;
+	}
+	else if(skip) {
+	    continue;
+	}
+	else if(field::is(f, "temperature.air")) {
+	    v.back().has_temperature = true;
+	    v.back().temperature = {f.val, f.val_end};
+	}
+	else if(field::is(f, "rain.amount")) {
+	    v.back().rain = {f.val, f.val_end};
+	}
+	else if(field::is(f, "wind.force.max")) {
+	    v.back().gust = {f.val, f.val_end};
+	}
+    }
+
+    std::stable_sort(begin(v), end(v), by_time);
+    for(const auto& obs : v) add(obs);
+}
+
+/**
+ * Read a rollup file.  Returns false on I/O errors, but silently
+ * ignores lines it doesn't understand.
+ */
+bool Rollup::read(std::istream& is)
+{
+    std::string s;
+    while(std::getline(is, s)) {
+	if(s.empty() || s[0]=='#') continue;
+	std::string key;
+	Bucket b;
+	if(parse(s, key, b)) val[key] = b;
+    }
+    return !is.bad();
+}
+
+/**
+ * Read the last 'size' octets of the open rollup file 'fd'; enough
+ * to add() recent samples, but buckets older than the ones read can
+ * no longer be updated.  Returns false on I/O errors, with errno
+ * set.
+ */
+bool Rollup::read_tail(int fd, size_t size)
+{
+    struct stat st;
+    if(fstat(fd, &st)) return false;
+    const bool partial = st.st_size > off_t(size);
+    const off_t offset = partial ? st.st_size - off_t(size) : 0;
+
+    std::string buf(st.st_size - offset, '\0');
+    size_t n = 0;
+    while(n < buf.size()) {
+	const ssize_t m = pread(fd, &buf[n], buf.size() - n, offset + n);
+	if(m==-1 && errno==EINTR) continue;
+	if(m==0) errno = EIO;
+	if(m <= 0) return false;
+	n += m;
+    }
+
+    std::istringstream is{buf};
+    if(partial) {
+	std::string s;
+	std::getline(is, s);
+    }
+    if(!read(is)) return false;
+
+    if(partial) {
+	const std::string none = "~";
+	floor_hour = floor_day = none;
+	for(const auto& kv : val) {
+	    const auto& key = kv.first;
+	    auto& floor = is_hour(key) ? floor_hour : floor_day;
+	    if(floor==none) floor = key;
+	}
+    }
+    return true;
+}
+
+/**
+ * Add a sample to its hour and day.  Returns false if it was ignored
+ * by both because they already include newer samples.  The sample's
+ * epoch must be set, as parsed from its time.
+ */
+bool Rollup::add(const Observation& obs)
+{
+    if(obs.time.size() < 13) return false;
+    const bool hour = add(obs.time.substr(0, 13), obs);
+    const bool day = add(obs.time.substr(0, 10), obs);
+    return hour || day;
+}
+
+bool Rollup::add(const std::string& key, const Observation& obs)
+{
+    auto it = val.find(key);
+    if(it==val.end()) {
+	const auto& floor = is_hour(key) ? floor_hour : floor_day;
+	if(key < floor) return false;
+	it = val.insert({key, {}}).first;
+    }
+
+    Bucket& b = it->second;
+    if(obs.epoch <= b.epoch) return false;
+    b.add(obs);
+    changed.insert(key);
+    return true;
+}
+
+/**
+ * Print the whole rollup.
+ */
+std::ostream& Rollup::put(std::ostream& os) const
+{
+    for(const auto& kv : val) ::put(os, kv.first, kv.second);
+    return os;
+}
+
+/**
+ * Print the buckets which add() changed, for appending to the
+ * rollup file.
+ */
+std::ostream& Rollup::put_changes(std::ostream& os) const
+{
+    for(const auto& key : changed) ::put(os, key, val.at(key));
+    return os;
+}
@@ -0,0 +1,119 @@
+/* -*- c++ -*-
+ *
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WEATHER_ROLLUP_H
+#define WEATHER_ROLLUP_H
+
+#include "value.h"
+
+#include <string>
+#include <map>
+#include <set>
+#include <iosfwd>
+#include <ctime>
+
+class Files;
+
+/**
+ * Hourly and daily summaries of a weather(5) file: the temperature
+ * (min, max and mean), rain and max wind gust.  They're keyed by the
+ * local time as it appears in the samples: "2022-11-27T23" for an
+ * hour and "2022-11-27" for a day.
+ *
+ * The rollup file is a line-oriented text file, one bucket per line:
+ *
+ *   key last samples rain tn tmin tmax tsum gust
+ *
+ * where 'last' is the newest sample included, 'rain' the sum of the
+ * rain.amount (mm/h) of all samples, and 'tsum' the sum of the 'tn'
+ * temperature.air values.  It's written incrementally by appending
+ * the buckets that changed; a later line for the same key replaces
+ * an earlier one.
+ *
+ * A bucket only accepts samples newer than the newest one it already
+ * includes; thus it's safe to feed it overlapping downloads, but
+ * samples which arrive out of order are ignored until the rollup is
+ * rebuilt from the weather(5) file.  Newer means later in time, as
+ * parsed by timestamp::parse(), not as text: in the hour repeated
+ * when summer time ends, 02:10+01:00 comes after 02:50+02:00, and
+ * both end up in the same hour bucket.
+ */
+class Rollup {
+public:
+    Rollup() = default;
+    explicit Rollup(Files& files);
+    Rollup(Files& files, const std::string& first, const std::string& last);
+
+    struct Observation {
+	std::string time;
+	std::time_t epoch = 0;
+	bool has_temperature = false;
+	Value temperature;
+	Value rain;
+	Value gust;
+    };
+
+    struct Bucket {
+	std::string last;
+	std::time_t epoch = 0;
+	unsigned samples = 0;
+	double rain = 0;
+	unsigned tn = 0;
+	Value tmin;
+	Value tmax;
+	double tsum = 0;
+	Value gust;
+
+	void add(const Observation& obs);
+	double mean() const { return tsum / tn; }
+	double rain_per_hour() const { return samples ? rain / samples : 0; }
+    };
+
+    bool read(std::istream& is);
+    bool read_tail(int fd, size_t size);
+
+    bool add(const Observation& obs);
+
+    std::ostream& put(std::ostream& os) const;
+    std::ostream& put_changes(std::ostream& os) const;
+
+    using Buckets = std::map<std::string, Bucket>;
+    const Buckets& buckets() const { return val; }
+
+    static bool is_hour(const std::string& key) { return key.size()==13; }
+    static bool is_day(const std::string& key) { return key.size()==10; }
+
+private:
+    bool add(const std::string& key, const Observation& obs);
+
+    Buckets val;
+    std::set<std::string> changed;
+    std::string floor_hour;
+    std::string floor_day;
+};
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "rollupfile.h"
+
+#include "rollup.h"
+#include "append.h"
+#include "timestamp.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+#include <unistd.h>
+
+namespace {
+
+    Rollup::Observation observation(const Sample& sample)
+    {
+	auto get = [&sample] (const char* name, Value& val) {
+		       const auto it = sample.data.find(name);
+		       if(it==end(sample.data)) return false;
+		       const auto& s = it->second;
+		       val = {s.data(), s.data() + s.size()};
+		       return true;
+		   };
+	Rollup::Observation obs;
+	obs.time = sample.time;
+	timestamp::parse(obs.time, obs.epoch);
+	obs.has_temperature = get("temperature.air", obs.temperature);
+	get("rain.amount", obs.rain);
+	get("wind.force.max", obs.gust);
+	return obs;
+    }
+}
+
+
+/**
+ * Update the rollup file 'path' with 'samples'.  Returns success,
+ * printing errors to 'err'.
+ */
+bool append_rollup(const std::string& path, const Samples& samples,
+		   const Append& append, std::ostream& err)
+{
+    const int fd = open_locked(path);
+    bool ok = fd!=-1 && append_rollup(fd, samples, append);
+    if(!ok) err << "cannot update '" << path << "': " << std::strerror(errno) << '\n';
+    if(fd!=-1) close(fd);
+    return ok;
+}
+
+/**
+ * Update the rollup file 'fd', which the caller has opened and
+ * locked with open_locked().  Returns success, or failure with errno
+ * set.
+ */
+bool append_rollup(int fd, const Samples& samples, const Append& append)
+{
+    Rollup rollup;
+    if(!rollup.read_tail(fd, 64 * 1024)) return false;
+
+    std::vector<Rollup::Observation> v;
+    for(const auto& sample : samples) v.push_back(observation(sample));
+    std::stable_sort(begin(v), end(v),
+		     [] (const Rollup::Observation& a, const Rollup::Observation& b) {
+			 return a.epoch < b.epoch;
+		     });
+    for(const auto& obs : v) rollup.add(obs);
+
+    std::ostringstream os;
+    rollup.put_changes(os);
+    if(os.str().empty()) return true;
+    return append(fd, os.str());
+}
@@ -25,6 +25,7 @@
  * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include "sample.h"
+#include "value.h"
 
 #include <unordered_set>
 #include <iostream>
@@ -100,7 +101,7 @@ namespace {
     {
 	const double n = std::strtod(s.c_str(), nullptr);
 	char buf[10];
-	std::snprintf(buf, sizeof buf, "%.1f", n * k);
+	fixed1(buf, sizeof buf, n * k);
 	const std::string res = buf;
 	if (res=="0.0") return "";
 	return res;
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "snapshot.h"
+
+#include "atomic.h"
+#include "append.h"
+#include "field.h"
+#include "timestamp.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+
+#include <unistd.h>
+
+
+/**
+ * The date of the sample in the snapshot file 'path', or "" if there
+ * is none.
+ */
+std::string snapshot_time(const std::string& path)
+{
+    std::ifstream is{path};
+    std::string s;
+    while(std::getline(is, s)) {
+	field::Field f;
+	if(field::split(f, s.data(), s.data() + s.size()) != field::Kind::field) continue;
+	if(field::is(f, "date")) return {f.val, f.val_end};
+    }
+    return "";
+}
+
+/**
+ * Replace the snapshot at 'path' with the newest of 'samples', unless
+ * it already contains something at least as new.  Returns success,
+ * printing errors to 'err'.
+ *
+ * Times are compared as instants, not as text, so the repeated hour
+ * when DST ends doesn't confuse it.  Samples with unparsable times
+ * are ignored; a snapshot with one is replaced.  The comparison and
+ * the replacement happen under the file's lock, so with several
+ * writers the newest sample wins.
+ */
+bool snapshot(const std::string& path, const Samples& samples,
+	      std::ostream& err)
+{
+    const Sample* newest = nullptr;
+    std::time_t t = 0;
+    for(const Sample& sample : samples) {
+	std::time_t st;
+	if(!timestamp::parse(sample.time, st)) continue;
+	if(!newest || st > t) {
+	    newest = &sample;
+	    t = st;
+	}
+    }
+    if(!newest) return true;
+
+    const int fd = open_locked(path);
+    if(fd==-1) {
+	err << "cannot lock '" << path << "': " << std::strerror(errno) << '\n';
+	return false;
+    }
+
+    bool ok = true;
+    std::time_t prev;
+    if(!timestamp::parse(snapshot_time(path), prev) || prev < t) {
+	AtomicFile file{path};
+	ok = bool(file);
+	if(ok) {
+	    file.os() << *newest;
+	    ok = file.commit();
+	}
+	if(!ok) err << "cannot write '" << path << "': " << file.error() << '\n';
+    }
+    close(fd);
+    return ok;
+}
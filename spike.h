@@ -29,6 +29,7 @@
 #define WEATHER_SPIKE_H
 
 #include <algorithm>
+#include <iterator>
 
 /**
  * This algorithm sees a range as split into sub-ranges, groups, by
@@ -55,12 +56,12 @@ It pop_group2(It& first, const It last, Equivalence eq)
     while(first != last) {
 	It it = std::adjacent_find(first, last, neq);
 	if(it!=last) {
-	    It it2 = next(it, 2);
+	    It it2 = std::next(it, 2);
 	    if(it2!=last && eq(*it, *it2)) {
 		first = it2;
 	    }
 	    else {
-		first = next(it);
+		first = std::next(it);
 		break;
 	    }
 	}
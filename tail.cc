@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "tail.h"
+
+#include "week.h"
+#include "field.h"
+#include "timestamp.h"
+
+#include <cstring>
+
+
+const char* tail(const char* const a, const char* b, const Week& week, unsigned n)
+{
+    unsigned older = 0;
+
+    while(a != b) {
+	auto nl = static_cast<const char*>(memrchr(a, '\n', b - a));
+	const char* const s = nl ? nl + 1 : a;
+
+	field::Field f;
+	if(field::split(f, s, b)==field::Kind::field && field::is(f, "date")) {
+	    std::time_t t;
+	    if(timestamp::parse(f.val, f.val_end, t)) {
+		if(week.scale(t) >= 0) {
+		    older = 0;
+		}
+		else if(++older == n) {
+		    return s;
+		}
+	    }
+	}
+	b = nl ? nl : a;
+    }
+    return a;
+}
@@ -0,0 +1,240 @@
+/*
+ * Microbenchmarks, not run as part of 'make check'.
+ * Run them with 'make bench'.
+ */
+#include <curves.h>
+#include <week.h>
+#include <files...h>
+#include <value.h>
+#include <plot.h>
+#include <area.h>
+#include <xml.h>
+#include <raster.h>
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <new>
+
+namespace {
+
+    unsigned long allocations = 0;
+}
+
+void* operator new(std::size_t n)
+{
+    allocations++;
+    if(void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Time and count allocations in f(), and print a line about it
+     * where the cost is divided by n (lines, elements, ...)
+     */
+    template <class F>
+    void measure(const char* name, unsigned long n, const char* unit, F f)
+    {
+	const unsigned long a0 = allocations;
+	const auto t0 = Clock::now();
+	f();
+	const auto t1 = Clock::now();
+	const unsigned long a1 = allocations;
+
+	const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+	char buf[100];
+	std::snprintf(buf, sizeof buf, "%-20s %8.1f ns %8.3f allocs  (per %s, %lu %ss)",
+		      name, ns / n, double(a1 - a0) / n, unit, n, unit);
+	std::cout << buf << std::endl;
+    }
+
+    /**
+     * A week of weather(5) data, one sample a minute, starting
+     * Monday 2018-11-19.
+     */
+    std::string week_of_data(unsigned long& lines)
+    {
+	std::ostringstream oss;
+	lines = 0;
+	for(unsigned i = 0; i < 7*24*60; i++) {
+	    char buf[300];
+	    std::snprintf(buf, sizeof buf,
+			  "date: 2018-11-%02uT%02u:%02u:00+01:00\n"
+			  "temperature.road:   8.4\n"
+			  "temperature.air :  %4.1f\n"
+			  "humidity        :  92.9\n"
+			  "rain.amount     :   0.%u\n"
+			  "wind.direction  :   %u\n"
+			  "wind.force      :   2.5\n"
+			  "wind.force.max  :   3.4\n"
+			  "\n",
+			  19 + i/(24*60), i/60 % 24, i % 60,
+			  -5 + (i % 200)/10.0,
+			  i % 10,
+			  i % 360);
+	    oss << buf;
+	    lines += 9;
+	}
+	return oss.str();
+    }
+
+    void curves()
+    {
+	unsigned long lines;
+	const std::string s = week_of_data(lines);
+	const Week week{"2018-11-21"};
+	const char* const a = s.data();
+
+	measure("curves", lines, "line", [&] {
+		    Files files{"data", a, a, a + s.size()};
+		    std::ostringstream err;
+		    const Curves curves{week, files, err};
+		});
+    }
+
+    void values()
+    {
+	const char* const v[] = {"6.7", "-14.4", "135", "02.49", "0.0"};
+	const unsigned long n = 1000000;
+	int sum = 0;
+
+	measure("value", n, "line", [&] {
+		    for(unsigned long i = 0; i < n; i++) {
+			const char* s = v[i % 5];
+			const Value val{s, s + std::char_traits<char>::length(s)};
+			sum += val < Value{} ? 1 : 0;
+		    }
+		});
+	if(sum==42) std::cout << '\n';
+    }
+
+    /**
+     * One-decimal formatting of SVG coordinates, printf versus the
+     * fixed-point formatters.
+     */
+    void numbers()
+    {
+	const unsigned long n = 1000000;
+	char buf[32];
+	unsigned long sum = 0;
+
+	measure("snprintf", n, "number", [&] {
+		    for(unsigned long i = 0; i < n; i++) {
+			sum += std::snprintf(buf, sizeof buf, "%.1f", i * 0.37 - 900);
+		    }
+		});
+	measure("fixed1", n, "number", [&] {
+		    for(unsigned long i = 0; i < n; i++) {
+			sum += fixed1(buf, sizeof buf, i * 0.37 - 900);
+		    }
+		});
+	measure("Value::format", n, "number", [&] {
+		    for(unsigned long i = 0; i < n; i++) {
+			const Value val = i * 0.37 - 900;
+			sum += val.format(buf, sizeof buf);
+		    }
+		});
+	if(sum==42) std::cout << '\n';
+    }
+
+    /**
+     * The number of elements in an XML document.
+     */
+    unsigned long elements(const std::string& s)
+    {
+	unsigned long n = 0;
+	for(size_t i = 1; i < s.size(); i++) {
+	    if(s[i-1]=='<' && std::isalpha(s[i])) n++;
+	}
+	return n;
+    }
+
+    /**
+     * Writing SVG: the xml::ostream on its own, with elements like
+     * those of a plot's background, and then rendering the week of
+     * data with WeekPlot.
+     */
+    void svg()
+    {
+	std::ofstream nil;
+	const unsigned long n = 100000;
+	measure("xml", n, "element", [&] {
+		    xml::ostream xos{nil};
+		    xos << xml::elem("svg");
+		    for(unsigned long i = 1; i < n; i++) {
+			xos << xml::elem("rect")
+			    << xml::attr("x", i * 0.1, 1)
+			    << xml::attr("y", int(i % 300))
+			    << xml::attr("width", 700u)
+			    << xml::attr("fill", "#e0e0e0")
+			    << xml::end;
+		    }
+		    xos << xml::end;
+		});
+
+	unsigned long lines;
+	const std::string s = week_of_data(lines);
+	const char* const a = s.data();
+	Files files{"data", a, a, a + s.size()};
+	std::ostringstream err;
+	const Curves curves{Week{"2018-11-21"}, files, err};
+
+	auto plot = [&curves] (std::ostream& os) {
+			const Area temperature{{-20, +30}, {700, 200}};
+			const SubArea rain{temperature, {0, 20}, 200 * 3/5};
+			const Area wind{temperature, {0, 20}, 50};
+			WeekPlot plot{os, Week{"2018-11-21"}, temperature, rain, wind};
+			plot.plot(true, curves);
+		    };
+	std::ostringstream oss;
+	plot(oss);
+	const unsigned times = 20;
+	measure("weekplot", times * elements(oss.str()), "element", [&] {
+		    for(unsigned i = 0; i < times; i++) plot(nil);
+		});
+	measure("png", times, "plot", [&] {
+		    for(unsigned i = 0; i < times; i++) {
+			raster::rasterize(oss.str()).png(nil);
+		    }
+		});
+
+	const Week week{"2018-11-21"};
+	const unsigned empties = 1000;
+	measure("background", empties, "plot", [&] {
+		    const Area temperature{{-20, +30}, {700, 200}};
+		    const SubArea rain{temperature, {0, 20}, 200 * 3/5};
+		    const Area wind{temperature, {0, 20}, 50};
+		    for(unsigned i = 0; i < empties; i++) {
+			WeekPlot plot{nil, week, temperature, rain, wind};
+		    }
+		});
+    }
+}
+
+int main()
+{
+    curves();
+    values();
+    numbers();
+    svg();
+    return 0;
+}
@@ -0,0 +1,364 @@
+#include <orchis.h>
+#include <iostream>
+namespace watch { void grow(orchis::TC); }
+namespace watch { void scan(orchis::TC); }
+namespace watch { void ignored(orchis::TC); }
+namespace watch { void replace(orchis::TC); }
+namespace xml { void three_stations(orchis::TC); }
+namespace xml { void empty(orchis::TC); }
+namespace xml { void plain(orchis::TC); }
+namespace xml { void truncated(orchis::TC); }
+namespace duration { void simple_days(orchis::TC); }
+namespace duration { void simple_hours(orchis::TC); }
+namespace duration { void invalid(orchis::TC); }
+namespace week { void by_timestamp(orchis::TC); }
+namespace week { void prev(orchis::TC); }
+namespace week { void scale(orchis::TC); }
+namespace week { void format(orchis::TC); }
+namespace week { void simple(orchis::TC); }
+namespace week { void summer(orchis::TC); }
+namespace week { void contains(orchis::TC); }
+namespace week { void equality(orchis::TC); }
+namespace week { void strftime(orchis::TC); }
+namespace timestamp { void dst(orchis::TC); }
+namespace timestamp { void local(orchis::TC); }
+namespace timestamp { void sweep(orchis::TC); }
+namespace timestamp { void offset(orchis::TC); }
+namespace timestamp { void invalid(orchis::TC); }
+namespace curves { void weeks_disordered(orchis::TC); }
+namespace curves { namespace cache { void grown(orchis::TC); }}
+namespace curves { namespace cache { void simple(orchis::TC); }}
+namespace curves { namespace cache { void rewritten(orchis::TC); }}
+namespace curves { namespace parse { void lines(orchis::TC); }}
+namespace curves { namespace parse { void plain(orchis::TC); }}
+namespace curves { namespace parse { void minimal(orchis::TC); }}
+namespace curves { namespace parse { void spacing(orchis::TC); }}
+namespace curves { namespace parse { void ordering(orchis::TC); }}
+namespace curves { namespace parse { void precision(orchis::TC); }}
+namespace curves { void weeks(orchis::TC); }
+namespace curves { void single(orchis::TC); }
+namespace curves { void columns(orchis::TC); }
+namespace curves { void nothing(orchis::TC); }
+namespace curves { namespace pattern { void Ww(orchis::TC); }}
+namespace curves { namespace pattern { void wW(orchis::TC); }}
+namespace curves { namespace pattern { void WWW(orchis::TC); }}
+namespace curves { namespace pattern { void WwwWW(orchis::TC); }}
+namespace curves { namespace pattern { void WwWWwW(orchis::TC); }}
+namespace curves { namespace parallel { void head(orchis::TC); }}
+namespace curves { namespace parallel { void chunks(orchis::TC); }}
+namespace curves { namespace parallel { void errors(orchis::TC); }}
+namespace curves { namespace parallel { void joined(orchis::TC); }}
+namespace curves { namespace parallel { void simple(orchis::TC); }}
+namespace reverse { void unterminated(orchis::TC); }
+namespace reverse { void all(orchis::TC); }
+namespace reverse { void empty(orchis::TC); }
+namespace reverse { void files(orchis::TC); }
+namespace reverse { void simple(orchis::TC); }
+namespace reverse { void disorder(orchis::TC); }
+namespace value { namespace format { void ties(orchis::TC); }}
+namespace value { namespace format { void value(orchis::TC); }}
+namespace value { namespace format { void random(orchis::TC); }}
+namespace value { namespace format { void truncated(orchis::TC); }}
+namespace value { namespace compare { void eq(orchis::TC); }}
+namespace value { namespace compare { void lt(orchis::TC); }}
+namespace value { namespace compare { void neq(orchis::TC); }}
+namespace value { namespace construct { void from_buffer(orchis::TC); }}
+namespace value { namespace construct { void from_double(orchis::TC); }}
+namespace value { namespace construct { void from_text(orchis::TC); }}
+namespace groups { void two(orchis::TC); }
+namespace groups { void list(orchis::TC); }
+namespace groups { void empty(orchis::TC); }
+namespace groups { void single(orchis::TC); }
+namespace groups { void string(orchis::TC); }
+namespace groups { void vector(orchis::TC); }
+namespace groups { void ungrouped(orchis::TC); }
+namespace stream { void attributes(orchis::TC); }
+namespace stream { void newline_suppression(orchis::TC); }
+namespace stream { namespace huge { void flat(orchis::TC); }}
+namespace stream { namespace huge { void nested(orchis::TC); }}
+namespace stream { namespace huge { void gigantic(orchis::TC); }}
+namespace stream { void basic(orchis::TC); }
+namespace stream { void empty(orchis::TC); }
+namespace stream { namespace indent { void zero(orchis::TC); }}
+namespace stream { namespace indent { void simple(orchis::TC); }}
+namespace stream { namespace indent { void attribute(orchis::TC); }}
+namespace stream { void object(orchis::TC); }
+namespace stream { void string(orchis::TC); }
+namespace stream { namespace quoting { void lt_gt(orchis::TC); }}
+namespace stream { namespace quoting { void ampersand(orchis::TC); }}
+namespace stream { namespace quoting { void attribute(orchis::TC); }}
+namespace stream { void strings(orchis::TC); }
+namespace stream { void fragment(orchis::TC); }
+namespace stream { void formatted(orchis::TC); }
+namespace files { void no_means_no(orchis::TC); }
+namespace files { void unterminated(orchis::TC); }
+namespace files { void err(orchis::TC); }
+namespace files { void many(orchis::TC); }
+namespace files { void null(orchis::TC); }
+namespace files { void null2(orchis::TC); }
+namespace files { void range(orchis::TC); }
+namespace files { void memory(orchis::TC); }
+namespace files { namespace string { void simple(orchis::TC); }}
+namespace files { void position(orchis::TC); }
+namespace files { void construct(orchis::TC); }
+namespace groups2 { void empty(orchis::TC); }
+namespace groups2 { void spike1(orchis::TC); }
+namespace groups2 { void spike2(orchis::TC); }
+namespace groups2 { void no_spike(orchis::TC); }
+namespace post { void single_station(orchis::TC); }
+namespace compact { void duplicates(orchis::TC); }
+namespace compact { void unparsable(orchis::TC); }
+namespace compact { void same_instant(orchis::TC); }
+namespace compact { void dst(orchis::TC); }
+namespace compact { void runs(orchis::TC); }
+namespace compact { void empty(orchis::TC); }
+namespace compact { void sorted(orchis::TC); }
+namespace compact { void comments(orchis::TC); }
+namespace compact { void disorder(orchis::TC); }
+namespace compact { void unsorted(orchis::TC); }
+namespace rollup { void dst_rebuild(orchis::TC); }
+namespace rollup { void dst(orchis::TC); }
+namespace rollup { namespace file { void interleaved(orchis::TC); }}
+namespace rollup { namespace file { void missing(orchis::TC); }}
+namespace rollup { void hour(orchis::TC); }
+namespace rollup { void empty(orchis::TC); }
+namespace rollup { void changes(orchis::TC); }
+namespace rollup { void overlap(orchis::TC); }
+namespace rollup { void rebuild(orchis::TC); }
+namespace rollup { void filtered(orchis::TC); }
+namespace path { namespace simplified { void hole(orchis::TC); }}
+namespace path { namespace simplified { void rain(orchis::TC); }}
+namespace path { namespace simplified { void span(orchis::TC); }}
+namespace path { namespace simplified { void corner(orchis::TC); }}
+namespace path { namespace simplified { void rounding(orchis::TC); }}
+namespace path { namespace simplified { void straight(orchis::TC); }}
+namespace path { namespace simplified { void backtrack(orchis::TC); }}
+namespace path { namespace decimated { void m4(orchis::TC); }}
+namespace path { namespace decimated { void dense(orchis::TC); }}
+namespace path { namespace decimated { void order(orchis::TC); }}
+namespace path { namespace decimated { void sparse(orchis::TC); }}
+namespace path { namespace decimated { void backtrack(orchis::TC); }}
+namespace period { namespace year { void simple(orchis::TC); }}
+namespace period { namespace year { void borders(orchis::TC); }}
+namespace period { namespace month { void prev(orchis::TC); }}
+namespace period { namespace month { void scale(orchis::TC); }}
+namespace period { namespace month { void simple(orchis::TC); }}
+namespace period { namespace month { void borders(orchis::TC); }}
+namespace gzip { void empty(orchis::TC); }
+namespace gzip { void large(orchis::TC); }
+namespace gzip { void simple(orchis::TC); }
+namespace raster { namespace svg { void path(orchis::TC); }}
+namespace raster { namespace svg { void rect(orchis::TC); }}
+namespace raster { namespace svg { void size(orchis::TC); }}
+namespace raster { namespace svg { void text(orchis::TC); }}
+namespace raster { namespace svg { void empty(orchis::TC); }}
+namespace raster { namespace svg { void group(orchis::TC); }}
+namespace raster { namespace svg { void entities(orchis::TC); }}
+namespace raster { namespace svg { void polyline(orchis::TC); }}
+namespace raster { void font(orchis::TC); }
+namespace raster { namespace canvas { void background(orchis::TC); }}
+namespace raster { namespace canvas { void png(orchis::TC); }}
+namespace raster { namespace canvas { void rect(orchis::TC); }}
+namespace raster { namespace canvas { void thin(orchis::TC); }}
+namespace raster { namespace canvas { void stroke(orchis::TC); }}
+namespace raster { namespace canvas { void opacity(orchis::TC); }}
+namespace raster { namespace canvas { void overlap(orchis::TC); }}
+namespace raster { namespace canvas { void triangle(orchis::TC); }}
+namespace raster { namespace weekplot { void unsupported(orchis::TC); }}
+namespace raster { namespace weekplot { void supported(orchis::TC); }}
+namespace http { void incomplete(orchis::TC); }
+namespace http { void bad(orchis::TC); }
+namespace http { void close(orchis::TC); }
+namespace http { void simple(orchis::TC); }
+namespace http { void response(orchis::TC); }
+namespace plotcache { void invalidate(orchis::TC); }
+namespace plotcache { void lru(orchis::TC); }
+namespace plotcache { void find(orchis::TC); }
+namespace plotcache { void size(orchis::TC); }
+namespace plotcache { void oversized(orchis::TC); }
+namespace snapshots { void dst(orchis::TC); }
+namespace snapshots { void empty(orchis::TC); }
+namespace snapshots { void older(orchis::TC); }
+namespace snapshots { void create(orchis::TC); }
+int main(int, char**) { int bad=0, n=0;
+  n++; try { watch::grow(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL watch::grow: " << e.what() << "\n"; }
+  n++; try { watch::scan(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL watch::scan: " << e.what() << "\n"; }
+  n++; try { watch::ignored(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL watch::ignored: " << e.what() << "\n"; }
+  n++; try { watch::replace(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL watch::replace: " << e.what() << "\n"; }
+  n++; try { xml::three_stations(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL xml::three_stations: " << e.what() << "\n"; }
+  n++; try { xml::empty(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL xml::empty: " << e.what() << "\n"; }
+  n++; try { xml::plain(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL xml::plain: " << e.what() << "\n"; }
+  n++; try { xml::truncated(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL xml::truncated: " << e.what() << "\n"; }
+  n++; try { duration::simple_days(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL duration::simple_days: " << e.what() << "\n"; }
+  n++; try { duration::simple_hours(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL duration::simple_hours: " << e.what() << "\n"; }
+  n++; try { duration::invalid(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL duration::invalid: " << e.what() << "\n"; }
+  n++; try { week::by_timestamp(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL week::by_timestamp: " << e.what() << "\n"; }
+  n++; try { week::prev(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL week::prev: " << e.what() << "\n"; }
+  n++; try { week::scale(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL week::scale: " << e.what() << "\n"; }
+  n++; try { week::format(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL week::format: " << e.what() << "\n"; }
+  n++; try { week::simple(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL week::simple: " << e.what() << "\n"; }
+  n++; try { week::summer(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL week::summer: " << e.what() << "\n"; }
+  n++; try { week::contains(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL week::contains: " << e.what() << "\n"; }
+  n++; try { week::equality(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL week::equality: " << e.what() << "\n"; }
+  n++; try { week::strftime(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL week::strftime: " << e.what() << "\n"; }
+  n++; try { timestamp::dst(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL timestamp::dst: " << e.what() << "\n"; }
+  n++; try { timestamp::local(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL timestamp::local: " << e.what() << "\n"; }
+  n++; try { timestamp::sweep(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL timestamp::sweep: " << e.what() << "\n"; }
+  n++; try { timestamp::offset(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL timestamp::offset: " << e.what() << "\n"; }
+  n++; try { timestamp::invalid(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL timestamp::invalid: " << e.what() << "\n"; }
+  n++; try { curves::weeks_disordered(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::weeks_disordered: " << e.what() << "\n"; }
+  n++; try { curves::cache::grown(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::cache::grown: " << e.what() << "\n"; }
+  n++; try { curves::cache::simple(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::cache::simple: " << e.what() << "\n"; }
+  n++; try { curves::cache::rewritten(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::cache::rewritten: " << e.what() << "\n"; }
+  n++; try { curves::parse::lines(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::parse::lines: " << e.what() << "\n"; }
+  n++; try { curves::parse::plain(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::parse::plain: " << e.what() << "\n"; }
+  n++; try { curves::parse::minimal(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::parse::minimal: " << e.what() << "\n"; }
+  n++; try { curves::parse::spacing(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::parse::spacing: " << e.what() << "\n"; }
+  n++; try { curves::parse::ordering(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::parse::ordering: " << e.what() << "\n"; }
+  n++; try { curves::parse::precision(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::parse::precision: " << e.what() << "\n"; }
+  n++; try { curves::weeks(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::weeks: " << e.what() << "\n"; }
+  n++; try { curves::single(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::single: " << e.what() << "\n"; }
+  n++; try { curves::columns(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::columns: " << e.what() << "\n"; }
+  n++; try { curves::nothing(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::nothing: " << e.what() << "\n"; }
+  n++; try { curves::pattern::Ww(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::pattern::Ww: " << e.what() << "\n"; }
+  n++; try { curves::pattern::wW(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::pattern::wW: " << e.what() << "\n"; }
+  n++; try { curves::pattern::WWW(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::pattern::WWW: " << e.what() << "\n"; }
+  n++; try { curves::pattern::WwwWW(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::pattern::WwwWW: " << e.what() << "\n"; }
+  n++; try { curves::pattern::WwWWwW(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::pattern::WwWWwW: " << e.what() << "\n"; }
+  n++; try { curves::parallel::head(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::parallel::head: " << e.what() << "\n"; }
+  n++; try { curves::parallel::chunks(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::parallel::chunks: " << e.what() << "\n"; }
+  n++; try { curves::parallel::errors(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::parallel::errors: " << e.what() << "\n"; }
+  n++; try { curves::parallel::joined(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::parallel::joined: " << e.what() << "\n"; }
+  n++; try { curves::parallel::simple(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL curves::parallel::simple: " << e.what() << "\n"; }
+  n++; try { reverse::unterminated(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL reverse::unterminated: " << e.what() << "\n"; }
+  n++; try { reverse::all(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL reverse::all: " << e.what() << "\n"; }
+  n++; try { reverse::empty(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL reverse::empty: " << e.what() << "\n"; }
+  n++; try { reverse::files(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL reverse::files: " << e.what() << "\n"; }
+  n++; try { reverse::simple(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL reverse::simple: " << e.what() << "\n"; }
+  n++; try { reverse::disorder(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL reverse::disorder: " << e.what() << "\n"; }
+  n++; try { value::format::ties(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL value::format::ties: " << e.what() << "\n"; }
+  n++; try { value::format::value(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL value::format::value: " << e.what() << "\n"; }
+  n++; try { value::format::random(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL value::format::random: " << e.what() << "\n"; }
+  n++; try { value::format::truncated(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL value::format::truncated: " << e.what() << "\n"; }
+  n++; try { value::compare::eq(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL value::compare::eq: " << e.what() << "\n"; }
+  n++; try { value::compare::lt(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL value::compare::lt: " << e.what() << "\n"; }
+  n++; try { value::compare::neq(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL value::compare::neq: " << e.what() << "\n"; }
+  n++; try { value::construct::from_buffer(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL value::construct::from_buffer: " << e.what() << "\n"; }
+  n++; try { value::construct::from_double(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL value::construct::from_double: " << e.what() << "\n"; }
+  n++; try { value::construct::from_text(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL value::construct::from_text: " << e.what() << "\n"; }
+  n++; try { groups::two(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL groups::two: " << e.what() << "\n"; }
+  n++; try { groups::list(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL groups::list: " << e.what() << "\n"; }
+  n++; try { groups::empty(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL groups::empty: " << e.what() << "\n"; }
+  n++; try { groups::single(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL groups::single: " << e.what() << "\n"; }
+  n++; try { groups::string(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL groups::string: " << e.what() << "\n"; }
+  n++; try { groups::vector(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL groups::vector: " << e.what() << "\n"; }
+  n++; try { groups::ungrouped(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL groups::ungrouped: " << e.what() << "\n"; }
+  n++; try { stream::attributes(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::attributes: " << e.what() << "\n"; }
+  n++; try { stream::newline_suppression(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::newline_suppression: " << e.what() << "\n"; }
+  n++; try { stream::huge::flat(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::huge::flat: " << e.what() << "\n"; }
+  n++; try { stream::huge::nested(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::huge::nested: " << e.what() << "\n"; }
+  n++; try { stream::huge::gigantic(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::huge::gigantic: " << e.what() << "\n"; }
+  n++; try { stream::basic(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::basic: " << e.what() << "\n"; }
+  n++; try { stream::empty(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::empty: " << e.what() << "\n"; }
+  n++; try { stream::indent::zero(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::indent::zero: " << e.what() << "\n"; }
+  n++; try { stream::indent::simple(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::indent::simple: " << e.what() << "\n"; }
+  n++; try { stream::indent::attribute(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::indent::attribute: " << e.what() << "\n"; }
+  n++; try { stream::object(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::object: " << e.what() << "\n"; }
+  n++; try { stream::string(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::string: " << e.what() << "\n"; }
+  n++; try { stream::quoting::lt_gt(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::quoting::lt_gt: " << e.what() << "\n"; }
+  n++; try { stream::quoting::ampersand(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::quoting::ampersand: " << e.what() << "\n"; }
+  n++; try { stream::quoting::attribute(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::quoting::attribute: " << e.what() << "\n"; }
+  n++; try { stream::strings(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::strings: " << e.what() << "\n"; }
+  n++; try { stream::fragment(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::fragment: " << e.what() << "\n"; }
+  n++; try { stream::formatted(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL stream::formatted: " << e.what() << "\n"; }
+  n++; try { files::no_means_no(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL files::no_means_no: " << e.what() << "\n"; }
+  n++; try { files::unterminated(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL files::unterminated: " << e.what() << "\n"; }
+  n++; try { files::err(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL files::err: " << e.what() << "\n"; }
+  n++; try { files::many(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL files::many: " << e.what() << "\n"; }
+  n++; try { files::null(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL files::null: " << e.what() << "\n"; }
+  n++; try { files::null2(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL files::null2: " << e.what() << "\n"; }
+  n++; try { files::range(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL files::range: " << e.what() << "\n"; }
+  n++; try { files::memory(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL files::memory: " << e.what() << "\n"; }
+  n++; try { files::string::simple(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL files::string::simple: " << e.what() << "\n"; }
+  n++; try { files::position(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL files::position: " << e.what() << "\n"; }
+  n++; try { files::construct(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL files::construct: " << e.what() << "\n"; }
+  n++; try { groups2::empty(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL groups2::empty: " << e.what() << "\n"; }
+  n++; try { groups2::spike1(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL groups2::spike1: " << e.what() << "\n"; }
+  n++; try { groups2::spike2(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL groups2::spike2: " << e.what() << "\n"; }
+  n++; try { groups2::no_spike(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL groups2::no_spike: " << e.what() << "\n"; }
+  n++; try { post::single_station(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL post::single_station: " << e.what() << "\n"; }
+  n++; try { compact::duplicates(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL compact::duplicates: " << e.what() << "\n"; }
+  n++; try { compact::unparsable(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL compact::unparsable: " << e.what() << "\n"; }
+  n++; try { compact::same_instant(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL compact::same_instant: " << e.what() << "\n"; }
+  n++; try { compact::dst(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL compact::dst: " << e.what() << "\n"; }
+  n++; try { compact::runs(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL compact::runs: " << e.what() << "\n"; }
+  n++; try { compact::empty(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL compact::empty: " << e.what() << "\n"; }
+  n++; try { compact::sorted(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL compact::sorted: " << e.what() << "\n"; }
+  n++; try { compact::comments(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL compact::comments: " << e.what() << "\n"; }
+  n++; try { compact::disorder(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL compact::disorder: " << e.what() << "\n"; }
+  n++; try { compact::unsorted(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL compact::unsorted: " << e.what() << "\n"; }
+  n++; try { rollup::dst_rebuild(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL rollup::dst_rebuild: " << e.what() << "\n"; }
+  n++; try { rollup::dst(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL rollup::dst: " << e.what() << "\n"; }
+  n++; try { rollup::file::interleaved(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL rollup::file::interleaved: " << e.what() << "\n"; }
+  n++; try { rollup::file::missing(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL rollup::file::missing: " << e.what() << "\n"; }
+  n++; try { rollup::hour(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL rollup::hour: " << e.what() << "\n"; }
+  n++; try { rollup::empty(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL rollup::empty: " << e.what() << "\n"; }
+  n++; try { rollup::changes(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL rollup::changes: " << e.what() << "\n"; }
+  n++; try { rollup::overlap(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL rollup::overlap: " << e.what() << "\n"; }
+  n++; try { rollup::rebuild(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL rollup::rebuild: " << e.what() << "\n"; }
+  n++; try { rollup::filtered(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL rollup::filtered: " << e.what() << "\n"; }
+  n++; try { path::simplified::hole(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL path::simplified::hole: " << e.what() << "\n"; }
+  n++; try { path::simplified::rain(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL path::simplified::rain: " << e.what() << "\n"; }
+  n++; try { path::simplified::span(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL path::simplified::span: " << e.what() << "\n"; }
+  n++; try { path::simplified::corner(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL path::simplified::corner: " << e.what() << "\n"; }
+  n++; try { path::simplified::rounding(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL path::simplified::rounding: " << e.what() << "\n"; }
+  n++; try { path::simplified::straight(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL path::simplified::straight: " << e.what() << "\n"; }
+  n++; try { path::simplified::backtrack(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL path::simplified::backtrack: " << e.what() << "\n"; }
+  n++; try { path::decimated::m4(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL path::decimated::m4: " << e.what() << "\n"; }
+  n++; try { path::decimated::dense(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL path::decimated::dense: " << e.what() << "\n"; }
+  n++; try { path::decimated::order(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL path::decimated::order: " << e.what() << "\n"; }
+  n++; try { path::decimated::sparse(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL path::decimated::sparse: " << e.what() << "\n"; }
+  n++; try { path::decimated::backtrack(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL path::decimated::backtrack: " << e.what() << "\n"; }
+  n++; try { period::year::simple(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL period::year::simple: " << e.what() << "\n"; }
+  n++; try { period::year::borders(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL period::year::borders: " << e.what() << "\n"; }
+  n++; try { period::month::prev(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL period::month::prev: " << e.what() << "\n"; }
+  n++; try { period::month::scale(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL period::month::scale: " << e.what() << "\n"; }
+  n++; try { period::month::simple(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL period::month::simple: " << e.what() << "\n"; }
+  n++; try { period::month::borders(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL period::month::borders: " << e.what() << "\n"; }
+  n++; try { gzip::empty(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL gzip::empty: " << e.what() << "\n"; }
+  n++; try { gzip::large(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL gzip::large: " << e.what() << "\n"; }
+  n++; try { gzip::simple(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL gzip::simple: " << e.what() << "\n"; }
+  n++; try { raster::svg::path(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::svg::path: " << e.what() << "\n"; }
+  n++; try { raster::svg::rect(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::svg::rect: " << e.what() << "\n"; }
+  n++; try { raster::svg::size(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::svg::size: " << e.what() << "\n"; }
+  n++; try { raster::svg::text(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::svg::text: " << e.what() << "\n"; }
+  n++; try { raster::svg::empty(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::svg::empty: " << e.what() << "\n"; }
+  n++; try { raster::svg::group(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::svg::group: " << e.what() << "\n"; }
+  n++; try { raster::svg::entities(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::svg::entities: " << e.what() << "\n"; }
+  n++; try { raster::svg::polyline(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::svg::polyline: " << e.what() << "\n"; }
+  n++; try { raster::font(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::font: " << e.what() << "\n"; }
+  n++; try { raster::canvas::background(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::canvas::background: " << e.what() << "\n"; }
+  n++; try { raster::canvas::png(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::canvas::png: " << e.what() << "\n"; }
+  n++; try { raster::canvas::rect(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::canvas::rect: " << e.what() << "\n"; }
+  n++; try { raster::canvas::thin(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::canvas::thin: " << e.what() << "\n"; }
+  n++; try { raster::canvas::stroke(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::canvas::stroke: " << e.what() << "\n"; }
+  n++; try { raster::canvas::opacity(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::canvas::opacity: " << e.what() << "\n"; }
+  n++; try { raster::canvas::overlap(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::canvas::overlap: " << e.what() << "\n"; }
+  n++; try { raster::canvas::triangle(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::canvas::triangle: " << e.what() << "\n"; }
+  n++; try { raster::weekplot::unsupported(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::weekplot::unsupported: " << e.what() << "\n"; }
+  n++; try { raster::weekplot::supported(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL raster::weekplot::supported: " << e.what() << "\n"; }
+  n++; try { http::incomplete(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL http::incomplete: " << e.what() << "\n"; }
+  n++; try { http::bad(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL http::bad: " << e.what() << "\n"; }
+  n++; try { http::close(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL http::close: " << e.what() << "\n"; }
+  n++; try { http::simple(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL http::simple: " << e.what() << "\n"; }
+  n++; try { http::response(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL http::response: " << e.what() << "\n"; }
+  n++; try { plotcache::invalidate(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL plotcache::invalidate: " << e.what() << "\n"; }
+  n++; try { plotcache::lru(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL plotcache::lru: " << e.what() << "\n"; }
+  n++; try { plotcache::find(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL plotcache::find: " << e.what() << "\n"; }
+  n++; try { plotcache::size(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL plotcache::size: " << e.what() << "\n"; }
+  n++; try { plotcache::oversized(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL plotcache::oversized: " << e.what() << "\n"; }
+  n++; try { snapshots::dst(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL snapshots::dst: " << e.what() << "\n"; }
+  n++; try { snapshots::empty(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL snapshots::empty: " << e.what() << "\n"; }
+  n++; try { snapshots::older(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL snapshots::older: " << e.what() << "\n"; }
+  n++; try { snapshots::create(orchis::TC{}); } catch(std::exception& e) { bad++; std::cerr << "FAIL snapshots::create: " << e.what() << "\n"; }
+  std::cerr << n << " tests, " << bad << " failed\n"; return bad!=0; }
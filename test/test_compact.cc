@@ -0,0 +1,157 @@
+#include <compact.h>
+
+#include <orchis.h>
+#include <sstream>
+
+namespace {
+
+    std::string sample(const char* date, unsigned n = 2)
+    {
+	std::string s = "date: ";
+	s += date;
+	s += '\n';
+	if(n > 0) s += "temperature.air :   6.7\n";
+	if(n > 1) s += "wind.force      :   2.5\n";
+	if(n > 2) s += "wind.force.max  :   3.4\n";
+	return s;
+    }
+
+    void assert_compacts(const std::string& src, const std::string& ref,
+			 size_t budget = 1 << 20)
+    {
+	std::istringstream is{src};
+	std::ostringstream os;
+	compact::Stats stats;
+	orchis::assert_true(compact::compact(is, os, budget, "/tmp", stats));
+	orchis::assert_eq(os.str(), ref);
+    }
+}
+
+namespace compact {
+
+    using orchis::TC;
+
+    void empty(TC)
+    {
+	assert_compacts("", "");
+	assert_compacts("\n\n", "");
+    }
+
+    void sorted(TC)
+    {
+	const std::string a = sample("2018-11-19T00:00:00");
+	const std::string b = sample("2018-11-19T00:10:00");
+	assert_compacts(a + '\n' + b, a + '\n' + b);
+    }
+
+    void unsorted(TC)
+    {
+	const std::string a = sample("2018-11-19T00:00:00");
+	const std::string b = sample("2018-11-19T00:10:00");
+	const std::string c = sample("2018-11-19T00:20:00");
+	assert_compacts(c + '\n' + a + "\n\n" + b, a + '\n' + b + '\n' + c);
+    }
+
+    void duplicates(TC)
+    {
+	const std::string a = sample("2018-11-19T00:00:00", 1);
+	const std::string A = sample("2018-11-19T00:00:00", 3);
+	const std::string b = sample("2018-11-19T00:10:00");
+	assert_compacts(a + '\n' + b + '\n' + A, A + '\n' + b);
+	assert_compacts(A + '\n' + b + '\n' + a, A + '\n' + b);
+	assert_compacts(b + '\n' + b + '\n' + b, b);
+    }
+
+    void comments(TC)
+    {
+	assert_compacts("# header\n"
+			"\n"
+			"date: 2018-11-19T00:10:00\n"
+			"# about b\n"
+			"wind.force: 2.5\n"
+			"\n"
+			"date: 2018-11-19T00:00:00\n"
+			"wind.force: 2.5",
+			"# header\n"
+			"\n"
+			"date: 2018-11-19T00:00:00\n"
+			"wind.force: 2.5\n"
+			"\n"
+			"date: 2018-11-19T00:10:00\n"
+			"# about b\n"
+			"wind.force: 2.5\n");
+    }
+
+    void runs(TC)
+    {
+	std::string src;
+	std::string ref;
+	for(int i=9; i>=0; i--) {
+	    char date[] = "2018-11-19T00:00:00";
+	    date[14] = '0' + i;
+	    src += sample(date, 1) + '\n' + sample(date, 2) + '\n';
+	}
+	for(int i=0; i<10; i++) {
+	    char date[] = "2018-11-19T00:00:00";
+	    date[14] = '0' + i;
+	    if(i) ref += '\n';
+	    ref += sample(date, 2);
+	}
+
+	std::istringstream is{src};
+	std::ostringstream os;
+	compact::Stats stats;
+	orchis::assert_true(compact::compact(is, os, 100, "/tmp", stats));
+	orchis::assert_eq(os.str(), ref);
+	orchis::assert_eq(stats.records, 20);
+	orchis::assert_eq(stats.duplicates, 10);
+	orchis::assert_gt(stats.runs, 1);
+    }
+
+    /* When summer time ends, the hour 02 is repeated, and the times
+     * no longer sort as text.
+     */
+    void dst(TC)
+    {
+	const std::string a = sample("2022-10-30T02:40:00+02:00");
+	const std::string b = sample("2022-10-30T02:50:00+02:00");
+	const std::string c = sample("2022-10-30T02:00:00+01:00");
+	const std::string d = sample("2022-10-30T02:10:00+01:00");
+	assert_compacts(b + '\n' + c + '\n' + a + '\n' + d,
+			a + '\n' + b + '\n' + c + '\n' + d);
+	assert_compacts(a + '\n' + b + '\n' + c + '\n' + d,
+			a + '\n' + b + '\n' + c + '\n' + d, 100);
+	assert_compacts(d + '\n' + c + '\n' + b + '\n' + a,
+			a + '\n' + b + '\n' + c + '\n' + d, 100);
+    }
+
+    void same_instant(TC)
+    {
+	const std::string a = sample("2022-10-30T01:00:00+00:00", 1);
+	const std::string A = sample("2022-10-30T02:00:00+01:00", 3);
+	const std::string b = sample("2022-10-30T02:10:00+01:00");
+	assert_compacts(a + '\n' + b + '\n' + A, A + '\n' + b);
+	assert_compacts(A + '\n' + a + '\n' + b, A + '\n' + b, 100);
+    }
+
+    void unparsable(TC)
+    {
+	const std::string a = sample("2018-11-19T00:00:00");
+	const std::string x = sample("yesterday");
+	const std::string y = sample("today");
+	assert_compacts(x + '\n' + a + '\n' + y + '\n' + x,
+			a + '\n' + y + '\n' + x);
+    }
+
+    void disorder(TC)
+    {
+	std::istringstream is{sample("2022-10-30T02:50:00+02:00") + '\n' +
+			      sample("2022-10-30T02:00:00+01:00") + '\n' +
+			      sample("2022-10-30T02:40:00+02:00")};
+	std::ostringstream os;
+	compact::Stats stats;
+	orchis::assert_true(compact::compact(is, os, 1 << 20, "/tmp", stats));
+	orchis::assert_eq(stats.records, 3);
+	orchis::assert_eq(stats.disorder, 1);
+    }
+}
@@ -1,9 +1,14 @@
 #include <curves.h>
 #include <week.h>
 #include <files...h>
+#include <cache.h>
 
 #include <orchis.h>
 #include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <unistd.h>
+#include <dirent.h>
 
 
 namespace {
@@ -69,6 +74,32 @@ namespace curves {
 	orchis::assert_eq(sample.wind_force_max,  3.4);
     }
 
+    void columns(TC)
+    {
+	std::stringstream ss;
+	ss << sample("2018-11-19T00:00:00")
+	   << "date: 2018-11-19T00:10:00\n"
+	   << sample("2018-11-19T00:20:00");
+	Files f(ss);
+
+	std::ostringstream err;
+	const Curves curves{Week{"2018-11-23T02:03:00"}, f, err};
+	const auto& curve = *curves.begin();
+	orchis::assert_eq(curve.size(), 2);
+	orchis::assert_eq(curve.t.size(), 2);
+	orchis::assert_eq(curve.wind_force.size(), 2);
+
+	unsigned n = 0;
+	for(const auto& sample : curve) {
+	    orchis::assert_eq(sample.t, curve.t[n]);
+	    orchis::assert_eq(sample.epoch, curve.epoch[n]);
+	    orchis::assert_eq(sample.temperature_air, curve.temperature_air[n]);
+	    n++;
+	}
+	orchis::assert_eq(n, 2);
+	orchis::assert_eq((--std::end(curve))->t, curve.t[1]);
+    }
+
     namespace pattern {
 
 	std::string count(const Curves& curves)
@@ -228,4 +259,282 @@ namespace curves {
 	    assert_ref(c);
 	}
     }
+
+    /* Reading several files in parallel gives the same result as
+     * reading them in sequence, including joining curves across
+     * file boundaries.
+     */
+    namespace parallel {
+
+	struct Tmp {
+	    explicit Tmp(const std::string& s)
+	    {
+		char tmpl[] = "/tmp/test_curves.XXXXXX";
+		const int fd = mkstemp(tmpl);
+		name = tmpl;
+		if(write(fd, s.data(), s.size())) {}
+		close(fd);
+	    }
+	    ~Tmp() { std::remove(name.c_str()); }
+	    std::string name;
+	};
+
+	std::string dump(const Curves& curves)
+	{
+	    std::ostringstream oss;
+	    for(const auto& curve : curves) {
+		for(const auto& s : curve) {
+		    oss << s.epoch << ' ' << s.temperature_air << ' '
+			<< s.wind_force << ' ' << s.wind_force_max << ' ';
+		}
+		oss << '\n';
+	    }
+	    return oss.str();
+	}
+
+	void assert_same(const std::vector<std::string>& src,
+			 const char* counts,
+			 size_t chunk = 4 << 20)
+	{
+	    std::vector<Tmp> tmp;
+	    tmp.reserve(src.size());
+	    std::vector<std::string> names;
+	    for(const auto& s : src) {
+		tmp.emplace_back(s);
+		names.push_back(tmp.back().name);
+	    }
+
+	    const Week week{"2018-11-23T02:03:00"};
+	    std::ostringstream err1;
+	    std::ostringstream err2;
+	    const Curves ref{week, names, 1, err1};
+	    const Curves curves{week, names, 4, err2, chunk};
+	    orchis::assert_eq(dump(curves), dump(ref));
+	    orchis::assert_eq(pattern::count(curves), counts);
+	    orchis::assert_eq(err2.str(), err1.str());
+	}
+
+	void simple(TC)
+	{
+	    assert_same({sample("2018-11-24T10:00:00"),
+			 sample("2018-10-01T00:00:00"),
+			 sample("2018-11-23T10:00:00")}, "11");
+	}
+
+	void joined(TC)
+	{
+	    assert_same({sample("2018-11-22T10:00:00"),
+			 sample("2018-11-22T11:00:00"),
+			 "",
+			 sample("2018-11-22T12:00:00") +
+			 sample("2018-10-01T00:00:00") +
+			 sample("2018-11-22T13:00:00")}, "31");
+	}
+
+	void head(TC)
+	{
+	    assert_same({sample("2018-11-22T10:00:00"),
+			 "temperature.air: -3.0\n",
+			 "wind.force: 8.0\n" + sample("2018-11-22T11:00:00"),
+			 "wind.force: 9.0\n" + sample("2018-10-01T00:00:00"),
+			 "wind.force: 10.0\n"}, "2");
+	}
+
+	void errors(TC)
+	{
+	    std::ostringstream err;
+	    const Curves curves{Week{"2018-11-23T02:03:00"}, {"/dev/null"}, 4, err};
+	    orchis::assert_true(curves.begin() == curves.end());
+	    assert_same({sample("2018-11-22T10:00:00") + "foo\n",
+			 "bar\n" + sample("2018-11-22T11:00:00")}, "2");
+	}
+
+	/* A file split into chunks.
+	 */
+	void chunks(TC)
+	{
+	    const std::string s = "# comment\n" +
+				  sample("2018-11-22T10:00:00") +
+				  sample("2018-11-22T11:00:00") +
+				  "foo\n" +
+				  sample("2018-10-01T00:00:00") +
+				  sample("2018-11-22T12:00:00") +
+				  sample("2018-11-22T13:00:00") +
+				  "bar\n" +
+				  sample("2018-12-01T00:00:00") +
+				  sample("2018-11-22T14:00:00");
+	    for(size_t chunk : {10, 100, 200, 1000}) {
+		assert_same({s}, "221", chunk);
+		assert_same({s, s}, "22321", chunk);
+	    }
+	}
+    }
+
+    /* Curves::weeks() over 's', compared to reading the weeks one
+     * by one.
+     */
+    std::vector<Curves> assert_weeks(const std::string& s,
+				     const std::vector<Week>& weeks)
+    {
+	std::stringstream ss{s};
+	Files f(ss);
+	std::ostringstream err;
+	const auto v = Curves::weeks(weeks, f, err);
+	orchis::assert_eq(v.size(), weeks.size());
+
+	for(unsigned i = 0; i < weeks.size(); i++) {
+	    std::stringstream ss{s};
+	    Files f(ss);
+	    std::ostringstream err1;
+	    const Curves ref{weeks[i], f, err1};
+	    orchis::assert_eq(parallel::dump(v[i]), parallel::dump(ref));
+	    orchis::assert_eq(err.str(), err1.str());
+	}
+	return v;
+    }
+
+    /* Several weeks in one pass; the sample at midnight to Monday
+     * belongs to both weeks, as usual.
+     */
+    void weeks(TC)
+    {
+	const std::string s = "temperature.air: 1.0\n" +
+			      sample("2018-11-15T10:00:00") +
+			      sample("2018-11-19T00:00:00") +
+			      "foo\n" +
+			      sample("2018-11-20T10:00:00") +
+			      sample("2018-11-01T10:00:00") +
+			      "rain.amount: 2.0\n" +
+			      sample("2018-11-22T10:00:00") +
+			      "date: garbage\n" +
+			      "rain.amount: 2.0\n" +
+			      sample("2018-11-27T10:00:00") +
+			      sample("2018-11-23T10:00:00");
+	const auto v = assert_weeks(s, {Week{"2018-11-12"},
+					Week{"2018-11-19"},
+					Week{"2018-11-26"}});
+	orchis::assert_eq(pattern::count(v[0]), "2");
+	orchis::assert_eq(pattern::count(v[1]), "211");
+	orchis::assert_eq(pattern::count(v[2]), "1");
+    }
+
+    /* Midnight to Monday, right after a sample in the later week:
+     * it still belongs to the earlier one too.
+     */
+    void weeks_disordered(TC)
+    {
+	const std::string s = sample("2018-11-27T10:00:00") +
+			      sample("2018-11-26T00:00:00") +
+			      sample("2018-11-25T10:00:00") +
+			      sample("2018-11-20T10:00:00") +
+			      sample("2018-11-19T00:00:00") +
+			      sample("2018-11-18T10:00:00") +
+			      sample("2018-11-26T00:00:00") +
+			      sample("2018-11-26T00:00:00");
+	const auto v = assert_weeks(s, {Week{"2018-11-12"},
+					Week{"2018-11-19"},
+					Week{"2018-11-26"}});
+	orchis::assert_eq(pattern::count(v[0]), "2");
+	orchis::assert_eq(pattern::count(v[1]), "42");
+	orchis::assert_eq(pattern::count(v[2]), "22");
+    }
+
+    namespace cache {
+
+	using parallel::Tmp;
+	using parallel::dump;
+
+	struct Dir {
+	    Dir()
+	    {
+		char tmpl[] = "/tmp/test_cache.XXXXXX";
+		name = mkdtemp(tmpl);
+	    }
+	    ~Dir()
+	    {
+		DIR* dir = opendir(name.c_str());
+		while(const dirent* e = readdir(dir)) {
+		    const std::string s = e->d_name;
+		    if(s!="." && s!="..") std::remove((name + '/' + s).c_str());
+		}
+		closedir(dir);
+		rmdir(name.c_str());
+	    }
+	    std::string name;
+	};
+
+	/* Read 'names' through a CurveCache in 'dir', and check that
+	 * the result is as if it wasn't there.  Returns the stats as
+	 * "hits partial misses".
+	 */
+	std::string check(const Dir& dir, const std::vector<std::string>& names,
+			  unsigned jobs = 1)
+	{
+	    const Week week{"2018-11-23T02:03:00"};
+	    std::ostringstream err1;
+	    std::ostringstream err2;
+	    const Curves ref{week, names, 1, err1};
+	    CurveCache cache{dir.name};
+	    const Curves curves{week, names, jobs, cache, err2, 100};
+	    orchis::assert_eq(dump(curves), dump(ref));
+	    orchis::assert_eq(err2.str(), err1.str());
+
+	    std::ostringstream oss;
+	    oss << cache.stats.hits << ' '
+		<< cache.stats.partial << ' '
+		<< cache.stats.misses;
+	    return oss.str();
+	}
+
+	void append(const Tmp& tmp, const std::string& s)
+	{
+	    std::ofstream os{tmp.name, std::ios::app};
+	    os << s;
+	}
+
+	void simple(TC)
+	{
+	    const Dir dir;
+	    const Tmp a{sample("2018-11-22T10:00:00") + "foo\n" +
+			sample("2018-11-22T11:00:00")};
+	    const Tmp b{sample("2018-11-22T12:00:00")};
+	    const std::vector<std::string> names {a.name, "/dev/null", b.name};
+
+	    orchis::assert_eq(check(dir, names), "0 0 2");
+	    orchis::assert_eq(check(dir, names), "2 0 0");
+	    orchis::assert_eq(check(dir, names, 4), "2 0 0");
+	}
+
+	void grown(TC)
+	{
+	    const Dir dir;
+	    const Tmp a{sample("2018-11-22T10:00:00")};
+	    const Tmp b{sample("2018-11-22T12:00:00")};
+	    const std::vector<std::string> names {a.name, b.name};
+
+	    orchis::assert_eq(check(dir, names), "0 0 2");
+	    append(a, "wind.force: 9.0\n" + sample("2018-11-22T11:00:00"));
+	    orchis::assert_eq(check(dir, names), "1 1 0");
+	    append(a, "bar\n" + sample("2018-10-01T00:00:00"));
+	    append(b, sample("2018-11-22T13:00:00"));
+	    orchis::assert_eq(check(dir, names, 4), "0 2 0");
+	    orchis::assert_eq(check(dir, names), "2 0 0");
+	}
+
+	void rewritten(TC)
+	{
+	    const Dir dir;
+	    const Tmp a{sample("2018-11-22T10:00:00")};
+	    const std::vector<std::string> names {a.name};
+
+	    orchis::assert_eq(check(dir, names), "0 0 1");
+	    {
+		std::ofstream os{a.name};
+		os << sample("2018-11-22T11:00:00")
+		   << sample("2018-11-22T12:00:00");
+	    }
+	    orchis::assert_eq(check(dir, names), "0 0 1");
+	    orchis::assert_eq(check(dir, names), "1 0 0");
+	}
+    }
 }
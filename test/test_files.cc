@@ -6,6 +6,9 @@
 
 #include <orchis.h>
 
+#include <cstdio>
+#include <unistd.h>
+
 namespace {
 
     std::vector<std::string> cat(const char* const* argv, size_t n)
@@ -41,6 +44,34 @@ namespace {
 	const char* const argv[] = {a, b, c, d};
 	return cat(argv, 4);
     }
+
+    std::vector<std::string> rcat(const char* a)
+    {
+	std::vector<std::string> acc;
+	Files f(&a, &a+1);
+	const char* p;
+	const char* q;
+	while(f.getline(p, q)) {
+	    acc.emplace_back(p, q);
+	}
+	return acc;
+    }
+
+    /**
+     * A temporary file, removed when it goes out of scope.
+     */
+    struct Tmp {
+	explicit Tmp(const char* s)
+	{
+	    char tmpl[] = "/tmp/test_files.XXXXXX";
+	    const int fd = mkstemp(tmpl);
+	    name = tmpl;
+	    if(write(fd, s, std::strlen(s))) {}
+	    close(fd);
+	}
+	~Tmp() { std::remove(name.c_str()); }
+	std::string name;
+    };
 }
 
 
@@ -113,6 +144,54 @@ namespace files {
 	assert_true(cat(devnull, dir, pass, pass) == p2);
     }
 
+    void range(TC)
+    {
+	assert_true(rcat(pass) == cat(pass, devnull));
+    }
+
+    void unterminated(TC)
+    {
+	const Tmp tmp{"foo\n\nbar"};
+	const char* const name = tmp.name.c_str();
+	const std::vector<std::string> ref = {"foo", "", "bar", "foo", "", "bar"};
+	assert_true(cat(name, name) == ref);
+
+	const Tmp tmp2{"foo\n\nbar\n"};
+	assert_true(rcat(tmp2.name.c_str()) == std::vector<std::string>(ref.begin(),
+									 ref.begin()+3));
+    }
+
+    void position(TC)
+    {
+	const Tmp tmp{"foo\nbar\n"};
+	const char* const argv[] = {tmp.name.c_str(), devnull, tmp.name.c_str()};
+	Files f(argv, argv+3);
+	const char* a;
+	const char* b;
+	for(unsigned line : {1, 2, 1, 2}) {
+	    assert_true(f.getline(a, b));
+	    assert_eq(f.position().file, tmp.name);
+	    assert_eq(f.position().line, line);
+	}
+	orchis::assert_false(f.getline(a, b));
+    }
+
+    void memory(TC)
+    {
+	const std::string s = "foo\nbar\nbaz";
+	const char* const origin = s.data();
+	Files f("name", origin, origin + 4, origin + s.size());
+	std::string line;
+	assert_true(f.getline(line));
+	assert_eq(line, "bar");
+	assert_eq(f.position().file, "name");
+	assert_eq(f.position().line, 2);
+	assert_true(f.getline(line));
+	assert_eq(line, "baz");
+	assert_eq(f.position().line, 3);
+	orchis::assert_false(f.getline(line));
+    }
+
     namespace string {
 
 	void assert_read(Files& f, unsigned line, const char* ref)
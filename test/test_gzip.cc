@@ -0,0 +1,74 @@
+#include <gzip.h>
+
+#include <orchis.h>
+#include <sstream>
+#include <string>
+#include <zlib.h>
+
+namespace {
+
+    std::string compress(const std::string& s, int level)
+    {
+	std::ostringstream oss;
+	Gzip gz {oss, level};
+	std::ostream os {&gz};
+	os << s;
+	orchis::assert_true(gz.finish());
+	orchis::assert_eq(gz.in(), s.size());
+	orchis::assert_eq(gz.out(), oss.str().size());
+	return oss.str();
+    }
+
+    std::string gunzip(const std::string& s)
+    {
+	z_stream z {};
+	inflateInit2(&z, 15 + 16);
+	z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(s.data()));
+	z.avail_in = s.size();
+	std::string acc;
+	int err;
+	do {
+	    char buf[1000];
+	    z.next_out = reinterpret_cast<Bytef*>(buf);
+	    z.avail_out = sizeof buf;
+	    err = inflate(&z, Z_NO_FLUSH);
+	    acc.append(buf, sizeof buf - z.avail_out);
+	} while(err==Z_OK);
+	inflateEnd(&z);
+	orchis::assert_eq(err, Z_STREAM_END);
+	return acc;
+    }
+}
+
+namespace gzip {
+
+    using orchis::TC;
+    using orchis::assert_eq;
+
+    void empty(TC)
+    {
+	const std::string s = compress("", 6);
+	assert_eq(s.substr(0, 2), "\x1f\x8b");
+	assert_eq(gunzip(s), "");
+    }
+
+    void simple(TC)
+    {
+	const std::string s = compress("Hello, world!\n", 6);
+	assert_eq(gunzip(s), "Hello, world!\n");
+    }
+
+    void large(TC)
+    {
+	std::string ref;
+	for(unsigned i = 0; i < 100000; i++) {
+	    ref += "  <rect x='" + std::to_string(i % 701) + "'/>\n";
+	}
+	const std::string fast = compress(ref, 1);
+	const std::string best = compress(ref, 9);
+	assert_eq(gunzip(fast), ref);
+	assert_eq(gunzip(best), ref);
+	orchis::assert_lt(best.size(), fast.size());
+	orchis::assert_lt(fast.size(), ref.size() / 5);
+    }
+}
@@ -0,0 +1,80 @@
+#include <http.h>
+
+#include <orchis.h>
+#include <string>
+
+namespace http {
+
+    using orchis::TC;
+    using orchis::assert_eq;
+    using orchis::assert_true;
+    using orchis::assert_false;
+
+    void simple(TC)
+    {
+	const std::string s = "GET /foo HTTP/1.1\r\n"
+	    "Host: localhost\r\n"
+	    "\r\n"
+	    "GET";
+	Request req;
+	size_t n;
+	assert_true(parse(s, n, req)==Parse::ok);
+	assert_eq(n, s.size() - 3);
+	assert_eq(req.method, "GET");
+	assert_eq(req.target, "/foo");
+	assert_true(req.keep_alive);
+    }
+
+    void incomplete(TC)
+    {
+	Request req;
+	size_t n;
+	assert_true(parse("", n, req)==Parse::incomplete);
+	assert_true(parse("GET / HTTP/1.1\r\n", n, req)==Parse::incomplete);
+	assert_true(parse("GET / HTTP/1.1\r\nHost: x\r\n\r", n, req)==Parse::incomplete);
+    }
+
+    void close(TC)
+    {
+	Request req;
+	size_t n;
+	assert_true(parse("GET / HTTP/1.1\r\n"
+			  "Connection: Close\r\n\r\n", n, req)==Parse::ok);
+	assert_false(req.keep_alive);
+	assert_true(parse("HEAD / HTTP/1.0\r\n\r\n", n, req)==Parse::ok);
+	assert_eq(req.method, "HEAD");
+	assert_false(req.keep_alive);
+	assert_true(parse("GET / HTTP/1.0\r\n"
+			  "connection:keep-alive\r\n\r\n", n, req)==Parse::ok);
+	assert_true(req.keep_alive);
+    }
+
+    void bad(TC)
+    {
+	Request req;
+	size_t n;
+	assert_true(parse("GET /\r\n\r\n", n, req)==Parse::bad);
+	assert_true(parse("GET / FTP/1.1\r\n\r\n", n, req)==Parse::bad);
+	assert_true(parse("GET / HTTP/1.1 x\r\n\r\n", n, req)==Parse::bad);
+	assert_true(parse("GET / HTTP/1.1\r\nHost\r\n\r\n", n, req)==Parse::bad);
+	assert_true(parse("POST / HTTP/1.1\r\n"
+			  "Content-Length: 5\r\n\r\nhello", n, req)==Parse::bad);
+	assert_true(parse(std::string(10000, 'x'), n, req)==Parse::bad);
+    }
+
+    void response(TC)
+    {
+	assert_eq(header(200, "image/svg+xml", 42, true),
+		  "HTTP/1.1 200 OK\r\n"
+		  "Content-Type: image/svg+xml\r\n"
+		  "Content-Length: 42\r\n"
+		  "Connection: keep-alive\r\n"
+		  "\r\n");
+	assert_eq(header(404, "text/plain", 0, false),
+		  "HTTP/1.1 404 Not Found\r\n"
+		  "Content-Type: text/plain\r\n"
+		  "Content-Length: 0\r\n"
+		  "Connection: close\r\n"
+		  "\r\n");
+    }
+}
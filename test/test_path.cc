@@ -0,0 +1,136 @@
+#include <path.h>
+
+#include <orchis.h>
+
+namespace path {
+
+    using orchis::TC;
+    using orchis::assert_eq;
+
+    namespace simplified {
+
+	std::string str(const Points& v)
+	{
+	    std::string s;
+	    return line(s, 10, v);
+	}
+
+	void straight(TC)
+	{
+	    Points v {{0, 0}, {1, 1}, {2, 2}, {3, 3.05}, {4, 4}};
+	    simplify(v, .1, 10);
+	    assert_eq(v.size(), 2);
+	    assert_eq(str(v), "M0.0 0.0 l4.0 4.0");
+	}
+
+	void corner(TC)
+	{
+	    Points v {{0, 0}, {1, 0}, {2, 0}, {3, 1}, {4, 2}};
+	    simplify(v, .1, 10);
+	    assert_eq(str(v), "M0.0 0.0 l2.0 0.0 2.0 2.0");
+	}
+
+	void hole(TC)
+	{
+	    Points v {{0, 0}, {1, 0}, {2, 0}, {20, 0}, {21, 0}, {22, 0}};
+	    simplify(v, .1, 10);
+	    assert_eq(str(v),
+		      "M0.0 0.0 l2.0 0.0\n"
+		      "M20.0 0.0 l2.0 0.0");
+	}
+
+	void backtrack(TC)
+	{
+	    Points v {{0, 0}, {1, 0}, {2, 0}, {1.5, 0}, {3, 0}, {4, 0}};
+	    simplify(v, .1, 10);
+	    assert_eq(str(v),
+		      "M0.0 0.0 l2.0 0.0\n"
+		      "M1.5 0.0 l2.5 0.0");
+	}
+
+	void span(TC)
+	{
+	    Points v;
+	    for(int i = 0; i <= 40; i++) v.push_back({i, 0});
+	    simplify(v, .1, 10);
+	    for(unsigned i = 1; i < v.size(); i++) {
+		orchis::assert_le(v[i].first - v[i-1].first, 10);
+	    }
+	    assert_eq(v.front().first, 0);
+	    assert_eq(v.back().first, 40);
+	    assert_eq(str(v).find('M', 1), std::string::npos);
+	}
+
+	void rounding(TC)
+	{
+	    Points v;
+	    for(int i = 0; i <= 30; i++) v.push_back({i * .31, i * .33});
+	    simplify(v, .1, 10);
+	    assert_eq(v.size(), 2);
+	    assert_eq(str(v), "M0.0 0.0 l9.3 9.9");
+	}
+
+	void rain(TC)
+	{
+	    Points v {{0, 5}, {1, 5}, {2, 5}, {3, 4}, {4, 3},
+		      {5, 5}, {6, 5}, {7, 5},
+		      {8, 1}, {9, 1}, {10, 1}};
+	    simplify_fill(v, .1, 5);
+	    const Points expected {{0, 5}, {2, 5}, {3, 4}, {4, 3},
+				   {5, 5}, {7, 5},
+				   {8, 1}, {10, 1}};
+	    orchis::assert_true(v==expected);
+	}
+    }
+
+    namespace decimated {
+
+	void sparse(TC)
+	{
+	    Points v {{0, 0}, {1.5, 1}, {2.5, 2}, {3.5, 3}};
+	    const Points w = v;
+	    decimate(v);
+	    orchis::assert_true(v==w);
+	}
+
+	void m4(TC)
+	{
+	    Points v {{0, 0},
+		      {1.0, 5}, {1.2, 9}, {1.4, 2}, {1.6, 7}, {1.8, 6},
+		      {2.1, 3}, {2.2, 3}, {2.3, 3},
+		      {3, 1}};
+	    decimate(v);
+	    const Points expected {{0, 0},
+				   {1.0, 5}, {1.2, 9}, {1.4, 2}, {1.8, 6},
+				   {2.1, 3}, {2.3, 3},
+				   {3, 1}};
+	    orchis::assert_true(v==expected);
+	}
+
+	void order(TC)
+	{
+	    Points v {{1.0, 5}, {1.2, 2}, {1.4, 3}, {1.6, 9}, {1.8, 6}};
+	    decimate(v);
+	    const Points expected {{1.0, 5}, {1.2, 2}, {1.6, 9}, {1.8, 6}};
+	    orchis::assert_true(v==expected);
+	}
+
+	void backtrack(TC)
+	{
+	    Points v {{1.1, 1}, {1.2, 2}, {1.3, 3}, {1.4, 4},
+		      {1.2, 5}, {1.3, 6}, {1.4, 7}, {1.5, 8}};
+	    decimate(v);
+	    const Points expected {{1.1, 1}, {1.4, 4},
+				   {1.2, 5}, {1.5, 8}};
+	    orchis::assert_true(v==expected);
+	}
+
+	void dense(TC)
+	{
+	    Points v;
+	    for(int i = 0; i < 10000; i++) v.push_back({i / 100.0, i % 7});
+	    decimate(v);
+	    orchis::assert_le(v.size(), 4 * 100);
+	}
+    }
+}
@@ -0,0 +1,89 @@
+#include <period.h>
+
+#include <orchis.h>
+#include <sstream>
+
+namespace {
+    /* Wed 2018-10-17 CEST */
+    const std::time_t wed = 1539810410;
+
+    template <class Period>
+    std::string str(const Period& p)
+    {
+	std::ostringstream oss;
+	oss << p;
+	return oss.str();
+    }
+}
+
+namespace period {
+
+    using orchis::TC;
+    using orchis::assert_eq;
+
+    namespace month {
+
+	void simple(TC)
+	{
+	    const Month m{wed};
+	    assert_eq(m.first(), "2018-10-01");
+	    assert_eq(m.last(), "2018-10-31");
+	    assert_eq(str(m), "10.2018");
+	    assert_eq(m.format("%Y-%m"), "2018-10");
+	}
+
+	void prev(TC)
+	{
+	    Month m{"2019-01-01T00:00:00"};
+	    assert_eq(m.first(), "2019-01-01");
+	    m = m.prev();
+	    assert_eq(m.first(), "2018-12-01");
+	    assert_eq(m.last(), "2018-12-31");
+	    m = Month{"2019-03-31T23:59:59"}.prev();
+	    assert_eq(m.last(), "2019-02-28");
+	}
+
+	void scale(TC)
+	{
+	    const Month m{wed};
+	    assert_eq(m.scale("2018-10-01T00:00:00"), 0);
+	    assert_eq(m.scale("2018-11-01T00:00:00"), 1);
+	    orchis::assert_lt(m.scale("2018-09-30T23:00:00"), 0);
+	    orchis::assert_true(m.contains(wed));
+	    assert_eq(m.scale("garbage"), -1);
+	}
+
+	void borders(TC)
+	{
+	    const Month m{wed};
+	    const auto v = m.borders();
+	    assert_eq(v.size(), 30);
+	    orchis::assert_lt(0, v.front());
+	    orchis::assert_lt(v.back(), 1);
+	    assert_eq(v[0], m.scale("2018-10-02T00:00:00"));
+	}
+    }
+
+    namespace year {
+
+	void simple(TC)
+	{
+	    const Year y{wed};
+	    assert_eq(y.first(), "2018-01-01");
+	    assert_eq(y.last(), "2018-12-31");
+	    assert_eq(str(y), "2018");
+	    assert_eq(str(y.prev()), "2017");
+	}
+
+	void borders(TC)
+	{
+	    const Year y{wed};
+	    const auto v = y.borders();
+	    assert_eq(v.size(), 11);
+	    assert_eq(v[0], y.scale("2018-02-01T00:00:00"));
+	    assert_eq(v[10], y.scale("2018-12-01T00:00:00"));
+	    orchis::assert_lt(y.scale("2018-07-02T00:00:00"), 0.5);
+	    orchis::assert_lt(0.5, y.scale("2018-07-03T00:00:00"));
+	}
+    }
+}
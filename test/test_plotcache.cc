@@ -0,0 +1,118 @@
+#include <plotcache.h>
+#include <week.h>
+#include <files...h>
+
+#include <orchis.h>
+#include <sstream>
+#include <string>
+
+namespace {
+
+    /**
+     * Curves with n samples, in the week of 2018-11-19.
+     */
+    Curves curves(unsigned n)
+    {
+	std::stringstream ss;
+	for(unsigned i = 0; i < n; i++) {
+	    ss << "date: 2018-11-19T1" << i << ":00:00\n"
+	       << "temperature.air :   6.7\n"
+	       << "wind.force      :   2.5\n";
+	}
+	Files f(ss);
+	std::ostringstream err;
+	return Curves{Week{"2018-11-23T02:03:00"}, f, err};
+    }
+
+    PlotCache::Plot plot(size_t n)
+    {
+	return std::make_shared<const std::string>(n, 'x');
+    }
+}
+
+namespace plotcache {
+
+    using orchis::TC;
+    using orchis::assert_eq;
+    using orchis::assert_true;
+
+    void size(TC)
+    {
+	assert_eq(PlotCache::size(curves(0)), 0);
+	const size_t one = PlotCache::size(curves(1));
+	assert_true(one > 0);
+	assert_eq(PlotCache::size(curves(3)), 3 * one);
+    }
+
+    void find(TC)
+    {
+	PlotCache cache {1000000};
+	assert_true(cache.find({0, "2018-11-19"})==nullptr);
+
+	PlotCache::Entry& e = cache.insert({0, "2018-11-19"}, curves(2));
+	assert_eq(cache.size(), PlotCache::size(curves(2)));
+	cache.add(e, "svg", plot(100));
+	assert_eq(cache.size(), PlotCache::size(curves(2)) + 100);
+	cache.add(e, "svg", plot(50));
+	assert_eq(cache.size(), PlotCache::size(curves(2)) + 50);
+
+	assert_true(cache.find({1, "2018-11-19"})==nullptr);
+	assert_true(cache.find({0, "2018-11-12"})==nullptr);
+	PlotCache::Entry* p = cache.find({0, "2018-11-19"});
+	assert_true(p==&e);
+	assert_eq(p->plots["svg"]->size(), 50);
+	assert_eq(cache.entries(), 1);
+    }
+
+    void lru(TC)
+    {
+	PlotCache cache {1000};
+	cache.add(cache.insert({0, "a"}, curves(0)), "svg", plot(400));
+	cache.add(cache.insert({0, "b"}, curves(0)), "svg", plot(400));
+	assert_eq(cache.entries(), 2);
+	assert_true(cache.find({0, "a"}));
+
+	cache.add(cache.insert({0, "c"}, curves(0)), "svg", plot(400));
+	assert_eq(cache.entries(), 2);
+	assert_eq(cache.size(), 800);
+	assert_true(cache.find({0, "a"}));
+	assert_true(cache.find({0, "b"})==nullptr);
+	assert_true(cache.find({0, "c"}));
+    }
+
+    void oversized(TC)
+    {
+	PlotCache cache {1000};
+	cache.add(cache.insert({0, "a"}, curves(0)), "svg", plot(400));
+	PlotCache::Entry& e = cache.insert({0, "b"}, curves(0));
+	cache.add(e, "svg", plot(2000));
+	assert_eq(cache.entries(), 1);
+	assert_true(cache.find({0, "b"})==&e);
+	assert_eq(cache.size(), 2000);
+    }
+
+    void invalidate(TC)
+    {
+	PlotCache cache {1000000};
+	cache.add(cache.insert({0, "a"}, curves(0)), "svg", plot(1));
+	cache.add(cache.insert({0, "b"}, curves(0)), "svg", plot(10));
+	cache.add(cache.insert({1, "a"}, curves(0)), "svg", plot(100));
+	cache.add(cache.insert({2, "a"}, curves(0)), "svg", plot(1000));
+
+	cache.invalidate(0, "b");
+	cache.invalidate(0, "c");
+	assert_eq(cache.entries(), 3);
+	assert_eq(cache.size(), 1101);
+
+	cache.invalidate(1);
+	assert_eq(cache.entries(), 2);
+	assert_eq(cache.size(), 1001);
+	assert_true(cache.find({0, "a"}));
+	assert_true(cache.find({2, "a"}));
+
+	cache.invalidate(0);
+	cache.invalidate(2);
+	assert_eq(cache.entries(), 0);
+	assert_eq(cache.size(), 0);
+    }
+}
@@ -0,0 +1,354 @@
+#include <raster.h>
+#include <font.h>
+#include <plot.h>
+#include <area.h>
+#include <curves.h>
+#include <files...h>
+#include <week.h>
+
+#include <orchis.h>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <zlib.h>
+
+namespace {
+
+    using raster::Canvas;
+    using raster::Color;
+
+    const Color white {255, 255, 255};
+    const Color black {0, 0, 0};
+
+    void assert_color(const Canvas& c, unsigned x, unsigned y,
+		      unsigned r, unsigned g, unsigned b)
+    {
+	const Color p = c.at(x, y);
+	orchis::assert_eq(unsigned(p.r), r);
+	orchis::assert_eq(unsigned(p.g), g);
+	orchis::assert_eq(unsigned(p.b), b);
+    }
+
+    void assert_gray(const Canvas& c, unsigned x, unsigned y, unsigned v)
+    {
+	assert_color(c, x, y, v, v, v);
+    }
+
+    std::string str(const std::set<std::string>& ss)
+    {
+	std::string acc;
+	for(const auto& s : ss) acc += s + ' ';
+	return acc;
+    }
+
+    /**
+     * The week of 2018-11-19 as plotted by WeekPlot (like
+     * weather_week -w does it) with two days of data, or none.
+     */
+    std::string plot_week(bool data)
+    {
+	std::stringstream ss;
+	for(unsigned i = 0; data && i < 2*24*6; i++) {
+	    char buf[300];
+	    std::snprintf(buf, sizeof buf,
+			  "date: 2018-11-%02uT%02u:%02u:00\n"
+			  "temperature.air :  %4.1f\n"
+			  "rain.amount     :   %u.0\n"
+			  "wind.direction  :   270\n"
+			  "wind.force      :   %u.5\n"
+			  "wind.force.max  :   %u.5\n"
+			  "\n",
+			  20 + i/(24*6), i/6 % 24, i % 6 * 10,
+			  -5 + (i % 100)/5.0,
+			  i % 50 < 10 ? 2 : 0,
+			  2 + i % 3, 5 + i % 3);
+	    ss << buf;
+	}
+	Files files(ss);
+	std::ostringstream err;
+	const Week week {"2018-11-21"};
+	const Curves curves {week, files, err};
+
+	std::ostringstream os;
+	{
+	    const Area temperature{{-20, +30}, {700, 200}};
+	    const SubArea rain{temperature, {0, 20}, 200 * 3/5};
+	    const Area wind{temperature, {0, 20}, 50};
+	    WeekPlot plot{os, week, temperature, rain, wind};
+	    plot.plot(true, curves);
+	}
+	return os.str();
+    }
+
+    /**
+     * The number of pixels which differ between two Canvases of the
+     * same size.
+     */
+    unsigned diff(const raster::Canvas& a, const raster::Canvas& b)
+    {
+	unsigned n = 0;
+	for(unsigned y = 0; y < a.height(); y++) {
+	    for(unsigned x = 0; x < a.width(); x++) {
+		const raster::Color p = a.at(x, y);
+		const raster::Color q = b.at(x, y);
+		n += p.r!=q.r || p.g!=q.g || p.b!=q.b;
+	    }
+	}
+	return n;
+    }
+
+    unsigned long get32(const std::string& s, size_t i)
+    {
+	unsigned long n = 0;
+	for(size_t j = i; j < i + 4; j++) n = n << 8 | (unsigned char)s[j];
+	return n;
+    }
+}
+
+namespace raster {
+
+    using orchis::TC;
+    using orchis::assert_eq;
+    using orchis::assert_true;
+    using orchis::assert_false;
+
+    namespace canvas {
+
+	void background(TC)
+	{
+	    const Canvas c {3, 2, {1, 2, 3}};
+	    assert_eq(c.width(), 3);
+	    assert_eq(c.height(), 2);
+	    assert_color(c, 0, 0, 1, 2, 3);
+	    assert_color(c, 2, 1, 1, 2, 3);
+	}
+
+	void rect(TC)
+	{
+	    Canvas c {10, 10, white};
+	    c.fill({{{2, 2}, {5, 2}, {5, 4.6}, {2, 4.6}}});
+	    c.paint(black, 1);
+	    assert_gray(c, 1, 2, 255);
+	    assert_gray(c, 2, 2, 0);
+	    assert_gray(c, 4, 3, 0);
+	    assert_gray(c, 5, 3, 255);
+	    assert_gray(c, 3, 4, 102);
+	    assert_gray(c, 3, 5, 255);
+	}
+
+	void opacity(TC)
+	{
+	    Canvas c {4, 4, white};
+	    c.fill({{{0, 0}, {4, 0}, {4, 4}, {0, 4}}});
+	    c.paint({255, 0, 0}, .5);
+	    assert_color(c, 1, 1, 255, 128, 128);
+	}
+
+	void overlap(TC)
+	{
+	    Canvas c {4, 4, white};
+	    c.fill({{{0, 0}, {3, 0}, {3, 4}, {0, 4}},
+		    {{1, 0}, {4, 0}, {4, 4}, {1, 4}}});
+	    c.paint(black, .5);
+	    assert_gray(c, 0, 1, 128);
+	    assert_gray(c, 1, 1, 128);
+	    assert_gray(c, 3, 1, 128);
+	}
+
+	void triangle(TC)
+	{
+	    Canvas c {10, 10, white};
+	    c.fill({{{0, 0}, {10, 10}, {0, 10}}});
+	    c.paint(black, 1);
+	    assert_gray(c, 1, 8, 0);
+	    assert_gray(c, 8, 1, 255);
+	    const Color p = c.at(5, 5);
+	    assert_true(p.r > 100 && p.r < 155);
+	}
+
+	void stroke(TC)
+	{
+	    Canvas c {10, 10, white};
+	    c.stroke({{{0, 5.5}, {10, 5.5}}}, 1);
+	    c.paint(black, 1);
+	    assert_gray(c, 5, 5, 0);
+	    assert_gray(c, 5, 4, 255);
+	    assert_gray(c, 5, 6, 255);
+	}
+
+	void thin(TC)
+	{
+	    Canvas c {10, 10, white};
+	    c.stroke({{{5.5, 0}, {5.5, 10}}}, .5);
+	    c.paint(black, 1);
+	    assert_gray(c, 5, 5, 128);
+	    assert_gray(c, 3, 5, 255);
+	}
+
+	void png(TC)
+	{
+	    Canvas c {3, 2, white};
+	    c.fill({{{0, 0}, {1, 0}, {1, 1}, {0, 1}}});
+	    c.paint({10, 20, 30}, 1);
+	    std::ostringstream oss;
+	    assert_true(c.png(oss));
+	    const std::string s = oss.str();
+
+	    assert_eq(s.substr(0, 8), "\x89PNG\r\n\x1a\n");
+	    assert_eq(get32(s, 8), 13);
+	    assert_eq(s.substr(12, 4), "IHDR");
+	    assert_eq(get32(s, 16), 3);
+	    assert_eq(get32(s, 20), 2);
+	    assert_eq(s.substr(33 + 4, 4), "IDAT");
+	    assert_eq(s.substr(s.size() - 8, 4), "IEND");
+
+	    const std::string idat = s.substr(33 + 8, get32(s, 33));
+	    std::string raw(100, 'x');
+	    uLongf n = raw.size();
+	    assert_eq(uncompress(reinterpret_cast<Bytef*>(&raw[0]), &n,
+				 reinterpret_cast<const Bytef*>(idat.data()),
+				 idat.size()), Z_OK);
+	    raw.resize(n);
+	    assert_eq(raw, std::string("\0\x0a\x14\x1e\xff\xff\xff\xff\xff\xff"
+				       "\0\xff\xff\xff\xff\xff\xff\xff\xff\xff", 20));
+	}
+    }
+
+    namespace svg {
+
+	void empty(TC)
+	{
+	    assert_eq(rasterize("").width(), 0);
+	    assert_eq(rasterize("<foo/>").width(), 0);
+	    assert_eq(rasterize("<svg></svg>").width(), 0);
+	}
+
+	void size(TC)
+	{
+	    const Canvas c = rasterize("<?xml version='1.0'?>\n"
+				       "<svg viewBox='0 0 20 10.5'/>\n");
+	    assert_eq(c.width(), 20);
+	    assert_eq(c.height(), 11);
+	    assert_gray(c, 0, 0, 255);
+	}
+
+	void rect(TC)
+	{
+	    const Canvas c = rasterize("<svg viewBox='10 0 20 10'>\n"
+				       "  <rect x='12' y='2' width='4' height='4'\n"
+				       "        fill='#ff0000'/>\n"
+				       "  <rect x='12' y='2' width='4' height='4'\n"
+				       "        fill='none' stroke='#00f'/>\n"
+				       "</svg>\n");
+	    assert_color(c, 3, 3, 255, 0, 0);
+	    assert_color(c, 2, 4, 128, 0, 128);
+	    assert_color(c, 1, 4, 128, 128, 255);
+	    assert_gray(c, 0, 3, 255);
+	}
+
+	void path(TC)
+	{
+	    const Canvas c = rasterize("<svg viewBox='0 0 10 10'>"
+				       "<path fill='black' opacity='.5'"
+				       " d='M1 1 l4 0 0 4 -4 0\n"
+				       "M6 6 l3 0 0 3 -3 0'/>"
+				       "</svg>");
+	    assert_gray(c, 2, 2, 128);
+	    assert_gray(c, 7, 7, 128);
+	    assert_gray(c, 5, 5, 255);
+	}
+
+	void polyline(TC)
+	{
+	    const Canvas c = rasterize("<svg viewBox='0 0 10 10'>"
+				       "<polyline stroke='black' fill='none'"
+				       " points='0,4.5 10,4.5'/>"
+				       "</svg>");
+	    assert_gray(c, 5, 4, 0);
+	    assert_gray(c, 5, 6, 255);
+	}
+
+	void group(TC)
+	{
+	    const Canvas c = rasterize("<svg viewBox='0 0 10 10'>"
+				       "<g opacity='.5'><g fill='#000000' opacity='.5'>"
+				       "<rect x='0' y='0' width='10' height='10'/>"
+				       "</g></g>"
+				       "</svg>");
+	    assert_gray(c, 5, 5, 191);
+	}
+
+	void text(TC)
+	{
+	    const Canvas c = rasterize("<svg viewBox='0 0 30 20'>\n"
+				       "  <text font-size='10' text-anchor='middle'>\n"
+				       "    <tspan x='14.5' y='15'>\n"
+				       "      I\n"
+				       "    </tspan>\n"
+				       "  </text>\n"
+				       "</svg>\n");
+	    assert_gray(c, 14, 10, 0);
+	    assert_gray(c, 12, 10, 255);
+	    assert_gray(c, 17, 10, 255);
+	    assert_gray(c, 14, 15, 255);
+	    assert_gray(c, 14, 7, 255);
+	}
+
+	void entities(TC)
+	{
+	    const Canvas a = rasterize("<svg viewBox='0 0 30 20'>"
+				       "<text x='0' y='10' font-size='10'>&#xb0;&lt;</text>"
+				       "</svg>");
+	    const Canvas b = rasterize("<svg viewBox='0 0 30 20'>"
+				       "<text x='0' y='10' font-size='10'>\xc2\xb0&#60;</text>"
+				       "</svg>");
+	    for(unsigned y = 0; y < 20; y++) {
+		for(unsigned x = 0; x < 30; x++) {
+		    assert_eq(a.at(x, y).r, b.at(x, y).r);
+		}
+	    }
+	    assert_eq(a.at(1, 4).r, 0);
+	}
+    }
+
+    /* The rasterizer only supports the parts of SVG that WeekPlot
+     * uses; if it starts using others, the PNGs silently lose them.
+     */
+    namespace weekplot {
+
+	void supported(TC)
+	{
+	    std::set<std::string> ignored;
+	    const Canvas c = rasterize(plot_week(true), ignored);
+	    assert_eq(str(ignored), "");
+	    assert_eq(c.width(), 740);
+	    assert_eq(c.height(), 250);
+
+	    const Canvas empty = rasterize(plot_week(false), ignored);
+	    assert_eq(str(ignored), "");
+	    assert_eq(empty.width(), c.width());
+	    assert_eq(empty.height(), c.height());
+	    assert_true(diff(c, empty) > 1000);
+	}
+
+	void unsupported(TC)
+	{
+	    std::set<std::string> ignored;
+	    rasterize("<svg viewBox='0 0 10 10' class='foo'>"
+		      "<circle cx='5' cy='5' r='2'/>"
+		      "<path d='M1 1 L2 2 C3 3 4 4 5 5'/>"
+		      "</svg>", ignored);
+	    assert_eq(str(ignored), "<circle> class= cx= cy= d=C r= ");
+	}
+    }
+
+    void font(TC)
+    {
+	assert_true(font::glyph('A'));
+	assert_true(font::glyph(0xb0));
+	assert_true(font::glyph(0xf6));
+	assert_false(font::glyph(0x263a));
+	assert_false(font::glyph('\n'));
+	assert_eq(font::glyph('I')[2], 0x7f);
+    }
+}
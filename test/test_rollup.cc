@@ -0,0 +1,259 @@
+#include <rollup.h>
+#include <rollupfile.h>
+#include <append.h>
+#include <files...h>
+#include <timestamp.h>
+
+#include <orchis.h>
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace {
+
+    Rollup::Observation obs(const char* time, double temp,
+			    double rain = 0, double gust = 0)
+    {
+	Rollup::Observation o;
+	o.time = time;
+	timestamp::parse(o.time, o.epoch);
+	o.has_temperature = true;
+	o.temperature = temp;
+	o.rain = rain;
+	o.gust = gust;
+	return o;
+    }
+
+    std::string str(const Rollup& r)
+    {
+	std::ostringstream oss;
+	r.put(oss);
+	return oss.str();
+    }
+
+    Sample sample(const char* time, const char* temp)
+    {
+	Sample s;
+	s.time = time;
+	s.data["temperature.air"] = temp;
+	return s;
+    }
+
+    /**
+     * A temporary directory and a rollup file in it, both removed
+     * when it goes out of scope.
+     */
+    struct Tmp {
+	Tmp()
+	{
+	    char tmpl[] = "/tmp/test_rollup.XXXXXX";
+	    dir = mkdtemp(tmpl);
+	    path = dir + "/station";
+	}
+	~Tmp()
+	{
+	    std::remove(path.c_str());
+	    rmdir(dir.c_str());
+	}
+	std::string dir;
+	std::string path;
+    };
+}
+
+namespace rollup {
+
+    using orchis::TC;
+    using orchis::assert_eq;
+
+    void empty(TC)
+    {
+	const Rollup r;
+	assert_eq(str(r), "");
+    }
+
+    void hour(TC)
+    {
+	Rollup r;
+	r.add(obs("2018-11-19T10:00:00", 1.0, 0.0, 3.0));
+	r.add(obs("2018-11-19T10:10:00", 3.0, 1.2, 5.0));
+	r.add(obs("2018-11-19T10:20:00", 2.0, 0.6, 4.0));
+
+	assert_eq(str(r),
+		  "2018-11-19 2018-11-19T10:20:00 3 1.8 3 1.0 3.0 6.0 5.0\n"
+		  "2018-11-19T10 2018-11-19T10:20:00 3 1.8 3 1.0 3.0 6.0 5.0\n");
+
+	const auto& b = r.buckets().at("2018-11-19T10");
+	assert_eq(b.mean(), 2.0);
+	assert_eq(b.rain_per_hour(), 0.6);
+    }
+
+    void overlap(TC)
+    {
+	Rollup r;
+	r.add(obs("2018-11-19T10:00:00", 1.0));
+	r.add(obs("2018-11-19T10:10:00", 3.0));
+	orchis::assert_false(r.add(obs("2018-11-19T10:00:00", 1.0)));
+	orchis::assert_false(r.add(obs("2018-11-19T10:10:00", 3.0)));
+	orchis::assert_true(r.add(obs("2018-11-19T11:00:00", -1.0)));
+
+	assert_eq(str(r),
+		  "2018-11-19 2018-11-19T11:00:00 3 0.0 3 -1.0 3.0 3.0 0.0\n"
+		  "2018-11-19T10 2018-11-19T10:10:00 2 0.0 2 1.0 3.0 4.0 0.0\n"
+		  "2018-11-19T11 2018-11-19T11:00:00 1 0.0 1 -1.0 -1.0 -1.0 0.0\n");
+    }
+
+    void changes(TC)
+    {
+	std::istringstream is{"2018-11-19 2018-11-19T10:10:00 2 0.0 2 1.0 3.0 4.0 0.0\n"
+			      "2018-11-19T10 2018-11-19T10:10:00 2 0.0 2 1.0 3.0 4.0 0.0\n"};
+	Rollup r;
+	r.read(is);
+	r.add(obs("2018-11-19T10:10:00", 3.0));
+	r.add(obs("2018-11-19T11:00:00", -1.0));
+
+	std::ostringstream oss;
+	r.put_changes(oss);
+	assert_eq(oss.str(),
+		  "2018-11-19 2018-11-19T11:00:00 3 0.0 3 -1.0 3.0 3.0 0.0\n"
+		  "2018-11-19T11 2018-11-19T11:00:00 1 0.0 1 -1.0 -1.0 -1.0 0.0\n");
+    }
+
+    void rebuild(TC)
+    {
+	std::stringstream ss;
+	ss << "date: 2018-11-19T10:10:00\n"
+	   << "temperature.air :   3.0\n"
+	   << "wind.force.max  :   5.0\n"
+	   << "\n"
+	   << "date: 2018-11-19T10:00:00\n"
+	   << "temperature.air :   1.0\n"
+	   << "rain.amount     :   1.2\n"
+	   << "\n"
+	   << "date: 2018-11-19T10:10:00\n"
+	   << "temperature.air :   3.0\n"
+	   << "wind.force.max  :   5.0\n";
+	Files f(ss);
+	const Rollup r{f};
+	assert_eq(str(r),
+		  "2018-11-19 2018-11-19T10:10:00 2 1.2 2 1.0 3.0 4.0 5.0\n"
+		  "2018-11-19T10 2018-11-19T10:10:00 2 1.2 2 1.0 3.0 4.0 5.0\n");
+    }
+
+    void filtered(TC)
+    {
+	std::stringstream ss;
+	ss << "date: 2018-10-31T23:10:00\n"
+	   << "temperature.air :   3.0\n"
+	   << "\n"
+	   << "date: 2018-11-01T00:10:00\n"
+	   << "temperature.air :   1.0\n"
+	   << "\n"
+	   << "date: 2018-11-30T23:10:00\n"
+	   << "temperature.air :   2.0\n"
+	   << "\n"
+	   << "date: 2018-12-01T00:00:00\n"
+	   << "temperature.air :   5.0\n";
+	Files f(ss);
+	const Rollup r{f, "2018-11-01", "2018-11-30"};
+	assert_eq(str(r),
+		  "2018-11-01 2018-11-01T00:10:00 1 0.0 1 1.0 1.0 1.0 0.0\n"
+		  "2018-11-01T00 2018-11-01T00:10:00 1 0.0 1 1.0 1.0 1.0 0.0\n"
+		  "2018-11-30 2018-11-30T23:10:00 1 0.0 1 2.0 2.0 2.0 0.0\n"
+		  "2018-11-30T23 2018-11-30T23:10:00 1 0.0 1 2.0 2.0 2.0 0.0\n");
+    }
+
+    /* When summer time ends, the hour 02 is repeated; the second
+     * time around, the samples sort before the first ones as text,
+     * but come after them in time.
+     */
+    void dst(TC)
+    {
+	Rollup r;
+	orchis::assert_true(r.add(obs("2022-10-30T02:40:00+02:00", 1.0)));
+	orchis::assert_true(r.add(obs("2022-10-30T02:50:00+02:00", 2.0)));
+	orchis::assert_true(r.add(obs("2022-10-30T02:00:00+01:00", 3.0)));
+	orchis::assert_true(r.add(obs("2022-10-30T02:10:00+01:00", 4.0)));
+	orchis::assert_false(r.add(obs("2022-10-30T02:50:00+02:00", 2.0)));
+
+	assert_eq(str(r),
+		  "2022-10-30 2022-10-30T02:10:00+01:00 4 0.0 4 1.0 4.0 10.0 0.0\n"
+		  "2022-10-30T02 2022-10-30T02:10:00+01:00 4 0.0 4 1.0 4.0 10.0 0.0\n");
+    }
+
+    void dst_rebuild(TC)
+    {
+	std::stringstream ss;
+	ss << "date: 2022-10-30T02:10:00+01:00\n"
+	   << "temperature.air :   4.0\n"
+	   << "\n"
+	   << "date: 2022-10-30T02:40:00+02:00\n"
+	   << "temperature.air :   1.0\n"
+	   << "\n"
+	   << "date: 2022-10-30T02:00:00+01:00\n"
+	   << "temperature.air :   3.0\n"
+	   << "\n"
+	   << "date: 2022-10-30T02:50:00+02:00\n"
+	   << "temperature.air :   2.0\n";
+	Files f(ss);
+	const Rollup r{f};
+	assert_eq(str(r),
+		  "2022-10-30 2022-10-30T02:10:00+01:00 4 0.0 4 1.0 4.0 10.0 0.0\n"
+		  "2022-10-30T02 2022-10-30T02:10:00+01:00 4 0.0 4 1.0 4.0 10.0 0.0\n");
+    }
+
+    namespace file {
+
+	/* A second update of the file, while the first one holds the
+	 * lock between reading the tail and appending to it, has to
+	 * wait and then see the first one's changes.
+	 */
+	void interleaved(TC)
+	{
+	    Tmp tmp;
+	    const Append append{true, Append::Sync::none};
+	    std::ostringstream err;
+	    orchis::assert_true(append_rollup(tmp.path,
+					      {sample("2018-11-19T10:00:00", "1.0")},
+					      append, err));
+
+	    const int fd = open_locked(tmp.path);
+	    orchis::assert_true(fd!=-1);
+	    bool ok = false;
+	    std::thread other {[&] {
+		ok = append_rollup(tmp.path,
+				   {sample("2018-11-19T10:20:00", "3.0")},
+				   append, err);
+	    }};
+	    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	    orchis::assert_true(append_rollup(fd,
+					      {sample("2018-11-19T10:10:00", "2.0")},
+					      append));
+	    close(fd);
+	    other.join();
+	    orchis::assert_true(ok);
+	    assert_eq(err.str(), "");
+
+	    Rollup r;
+	    std::ifstream is{tmp.path};
+	    orchis::assert_true(r.read(is));
+	    assert_eq(str(r),
+		      "2018-11-19 2018-11-19T10:20:00 3 0.0 3 1.0 3.0 6.0 0.0\n"
+		      "2018-11-19T10 2018-11-19T10:20:00 3 0.0 3 1.0 3.0 6.0 0.0\n");
+	}
+
+	void missing(TC)
+	{
+	    Tmp tmp;
+	    std::ostringstream err;
+	    orchis::assert_false(append_rollup(tmp.dir + "/no/such",
+					       {sample("2018-11-19T10:00:00", "1.0")},
+					       Append{true, Append::Sync::none}, err));
+	    assert_eq(err.str(), "cannot update '" + tmp.dir +
+		      "/no/such': No such file or directory\n");
+	}
+    }
+}
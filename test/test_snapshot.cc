@@ -0,0 +1,106 @@
+#include <snapshot.h>
+
+#include <orchis.h>
+
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace {
+
+    Sample sample(const char* time, const char* temp)
+    {
+	Sample s;
+	s.time = time;
+	s.data["temperature.air"] = temp;
+	return s;
+    }
+
+    /**
+     * A temporary directory and a snapshot file in it, both removed
+     * when it goes out of scope.
+     */
+    struct Tmp {
+	Tmp()
+	{
+	    char tmpl[] = "/tmp/test_snapshot.XXXXXX";
+	    dir = mkdtemp(tmpl);
+	    path = dir + "/station";
+	}
+	~Tmp()
+	{
+	    std::remove(path.c_str());
+	    rmdir(dir.c_str());
+	}
+	std::string dir;
+	std::string path;
+    };
+
+    bool snap(const Tmp& tmp, const Samples& samples)
+    {
+	std::ostringstream err;
+	const bool ok = snapshot(tmp.path, samples, err);
+	orchis::assert_eq(err.str(), "");
+	return ok;
+    }
+
+    std::string cat(const std::string& path)
+    {
+	std::ifstream is{path};
+	std::ostringstream ss;
+	ss << is.rdbuf();
+	return ss.str();
+    }
+}
+
+namespace snapshots {
+
+    using orchis::TC;
+    using orchis::assert_eq;
+    using orchis::assert_true;
+
+    void create(TC)
+    {
+	Tmp tmp;
+	assert_true(snap(tmp, {sample("2022-10-29T10:00:00+02:00", "1.0"),
+			       sample("2022-10-29T11:00:00+02:00", "2.0"),
+			       sample("2022-10-29T09:00:00+02:00", "3.0")}));
+	assert_eq(snapshot_time(tmp.path), "2022-10-29T11:00:00+02:00");
+    }
+
+    void empty(TC)
+    {
+	Tmp tmp;
+	assert_true(snap(tmp, {}));
+	assert_eq(snapshot_time(tmp.path), "");
+	assert_true(snap(tmp, {sample("garbage", "1.0")}));
+	assert_eq(snapshot_time(tmp.path), "");
+    }
+
+    void older(TC)
+    {
+	Tmp tmp;
+	assert_true(snap(tmp, {sample("2022-10-29T11:00:00+02:00", "2.0")}));
+	const std::string s = cat(tmp.path);
+	assert_true(snap(tmp, {sample("2022-10-29T10:00:00+02:00", "1.0")}));
+	assert_true(snap(tmp, {sample("2022-10-29T11:00:00+02:00", "3.0")}));
+	assert_eq(cat(tmp.path), s);
+	assert_true(snap(tmp, {sample("2022-10-29T11:10:00+02:00", "4.0")}));
+	assert_eq(snapshot_time(tmp.path), "2022-10-29T11:10:00+02:00");
+    }
+
+    void dst(TC)
+    {
+	Tmp tmp;
+	assert_true(snap(tmp, {sample("2022-10-30T02:50:00+02:00", "1.0"),
+			       sample("2022-10-30T02:10:00+01:00", "2.0")}));
+	assert_eq(snapshot_time(tmp.path), "2022-10-30T02:10:00+01:00");
+
+	assert_true(snap(tmp, {sample("2022-10-30T02:40:00+02:00", "3.0")}));
+	assert_eq(snapshot_time(tmp.path), "2022-10-30T02:10:00+01:00");
+	assert_true(snap(tmp, {sample("2022-10-30T02:20:00+01:00", "4.0")}));
+	assert_eq(snapshot_time(tmp.path), "2022-10-30T02:20:00+01:00");
+    }
+}
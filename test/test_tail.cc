@@ -0,0 +1,117 @@
+#include <tail.h>
+#include <week.h>
+#include <files...h>
+
+#include <orchis.h>
+#include <sstream>
+#include <cstdio>
+#include <unistd.h>
+
+namespace {
+
+    const Week week{"2018-11-19"};
+
+    std::string sample(const char* date)
+    {
+	std::ostringstream ss;
+	ss << "date: " << date << '\n'
+	   << "temperature.air: 1.0\n"
+	   << '\n';
+	return ss.str();
+    }
+
+    std::string data(std::initializer_list<const char*> dates)
+    {
+	std::string s;
+	for(auto date : dates) s += sample(date);
+	return s;
+    }
+
+    /**
+     * The data from where tail() tells us to start.
+     */
+    std::string tail(const std::string& s, unsigned n)
+    {
+	const char* a = s.data();
+	const char* b = a + s.size();
+	return {::tail(a, b, week, n), b};
+    }
+}
+
+namespace reverse {
+
+    using orchis::TC;
+    using orchis::assert_eq;
+
+    void empty(TC)
+    {
+	assert_eq(tail("", 1), "");
+	assert_eq(tail("\n\n", 1), "\n\n");
+    }
+
+    void all(TC)
+    {
+	const std::string s = data({"2018-11-19T00:00:00",
+				    "2018-11-20T00:00:00"});
+	assert_eq(tail(s, 1), s);
+    }
+
+    void simple(TC)
+    {
+	const std::string s = data({"2018-11-17T00:00:00",
+				    "2018-11-18T00:00:00",
+				    "2018-11-19T00:00:00",
+				    "2018-11-20T00:00:00"});
+	assert_eq(tail(s, 1), data({"2018-11-18T00:00:00",
+				    "2018-11-19T00:00:00",
+				    "2018-11-20T00:00:00"}));
+	assert_eq(tail(s, 2), s);
+	assert_eq(tail(s, 3), s);
+    }
+
+    void disorder(TC)
+    {
+	const std::string s = data({"2018-11-16T00:00:00",
+				    "2018-11-17T00:00:00",
+				    "2018-11-19T00:00:00",
+				    "2018-11-18T00:00:00",
+				    "2018-11-20T00:00:00"});
+	assert_eq(tail(s, 1), data({"2018-11-18T00:00:00",
+				    "2018-11-20T00:00:00"}));
+	assert_eq(tail(s, 2), s);
+    }
+
+    void unterminated(TC)
+    {
+	const std::string s = "date: 2018-11-18T00:00:00\n"
+			      "\n"
+			      "date: 2018-11-19T00:00:00";
+	assert_eq(tail(s, 1), s);
+	assert_eq(tail(s.substr(0, 26), 1), "date: 2018-11-18T00:00:00\n");
+    }
+
+    /* Files::seek(), and the line numbers after seeking.
+     */
+    void files(TC)
+    {
+	char name[] = "/tmp/test_tail.XXXXXX";
+	const int fd = mkstemp(name);
+	const std::string s = data({"2018-11-17T00:00:00",
+				    "2018-11-18T00:00:00",
+				    "2018-11-19T00:00:00"});
+	if(write(fd, s.data(), s.size())) {}
+	close(fd);
+
+	const char* const argv[] = {name};
+	Files f(argv, argv+1);
+	f.seek([] (const char* a, const char* b) { return ::tail(a, b, week, 1); });
+
+	std::string line;
+	orchis::assert_true(f.getline(line));
+	assert_eq(line, "date: 2018-11-18T00:00:00");
+	assert_eq(f.position().line, 4);
+	orchis::assert_true(f.getline(line));
+	assert_eq(f.position().line, 5);
+	std::remove(name);
+    }
+}
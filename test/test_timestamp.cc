@@ -0,0 +1,133 @@
+#include <timestamp.h>
+
+#include <orchis.h>
+
+namespace {
+
+    std::time_t epoch(const char* s)
+    {
+	std::time_t t = 4711;
+	orchis::assert_true(timestamp::parse(s, t));
+	return t;
+    }
+
+    void assert_invalid(const char* s)
+    {
+	std::time_t t = 4711;
+	orchis::assert_false(timestamp::parse(s, t));
+	orchis::assert_eq(t, 4711);
+    }
+
+    bool ambiguous(std::time_t t)
+    {
+	std::tm tm;
+	localtime_r(&t, &tm);
+	for(int dt : {-3600, -1800, 1800, 3600}) {
+	    const std::time_t t2 = t + dt;
+	    std::tm tm2;
+	    localtime_r(&t2, &tm2);
+	    if(tm2.tm_hour==tm.tm_hour && tm2.tm_min==tm.tm_min) return true;
+	}
+	return false;
+    }
+
+    std::time_t mktime(int y, int m, int d, int hh, int mm, int ss)
+    {
+	std::tm tm = {};
+	tm.tm_year = y - 1900;
+	tm.tm_mon = m - 1;
+	tm.tm_mday = d;
+	tm.tm_hour = hh;
+	tm.tm_min = mm;
+	tm.tm_sec = ss;
+	tm.tm_isdst = -1;
+	return std::mktime(&tm);
+    }
+}
+
+namespace timestamp {
+
+    using orchis::TC;
+    using orchis::assert_eq;
+
+    void offset(TC)
+    {
+	assert_eq(epoch("2022-11-27T22:05:03Z"), 1669586703);
+	assert_eq(epoch("2022-11-27T23:05:03+01:00"), 1669586703);
+	assert_eq(epoch("2022-11-27T23:05:03.001+01:00"), 1669586703);
+	assert_eq(epoch("2022-11-27T23:05:03,5+0100"), 1669586703);
+	assert_eq(epoch("2022-11-28T00:05:03+02"), 1669586703);
+	assert_eq(epoch("2022-11-27T17:05:03-05:00"), 1669586703);
+	assert_eq(epoch("1970-01-01T00:00:00Z"), 0);
+	assert_eq(epoch("2000-03-01T00:00:00Z"), 951868800);
+	assert_eq(epoch("2100-03-01T00:00:00Z"), 4107542400);
+    }
+
+    void local(TC)
+    {
+	assert_eq(epoch("2018-10-06T22:20:00"), mktime(2018, 10, 6, 22, 20, 0));
+	assert_eq(epoch("2018-10-06T22:20"), mktime(2018, 10, 6, 22, 20, 0));
+	assert_eq(epoch("2018-10-06"), mktime(2018, 10, 6, 0, 0, 0));
+	assert_eq(epoch("2018-10-06 22:20:00.3"), mktime(2018, 10, 6, 22, 20, 0));
+	assert_eq(epoch("2150-01-01T12:00:00"), mktime(2150, 1, 1, 12, 0, 0));
+    }
+
+    void dst(TC)
+    {
+	const std::time_t t = epoch("2018-10-28T02:30:00");
+	std::time_t t2 = t + 3600;
+	std::tm tm;
+	localtime_r(&t2, &tm);
+	if(tm.tm_hour==2) {
+	    /* Europe/Stockholm-like; the first 02:30 is the DST one */
+	    localtime_r(&t, &tm);
+	    assert_eq(tm.tm_isdst, 1);
+	}
+    }
+
+    /* Agrees with mktime(3) at half past every hour for a few
+     * years, except in the hour skipped when DST starts and the one
+     * repeated when it ends, where mktime() is unpredictable.
+     */
+    void sweep(TC)
+    {
+	char buf[30];
+	for(int y = 2018; y < 2021; y++) {
+	    for(int m = 1; m <= 12; m++) {
+		for(int d = 1; d <= 28; d++) {
+		    for(int hh = 0; hh < 24; hh++) {
+			const std::time_t ref = mktime(y, m, d, hh, 30, 0);
+			std::tm tm;
+			localtime_r(&ref, &tm);
+			if(tm.tm_hour != hh) continue;
+			if(ambiguous(ref)) continue;
+			std::snprintf(buf, sizeof buf, "%04d-%02d-%02dT%02d:30:00",
+				      y, m, d, hh);
+			assert_eq(epoch(buf), ref);
+		    }
+		}
+	    }
+	}
+    }
+
+    void invalid(TC)
+    {
+	assert_invalid("");
+	assert_invalid("2018");
+	assert_invalid("2018-10");
+	assert_invalid("2018-10-6");
+	assert_invalid("2018-13-06");
+	assert_invalid("2018-10-00");
+	assert_invalid("2018-10-06T");
+	assert_invalid("2018-10-06T22");
+	assert_invalid("2018-10-06T22:20:");
+	assert_invalid("2018-10-06T22:20:00.");
+	assert_invalid("2018-10-06T22:61:00");
+	assert_invalid("2018-10-06T22:20:00+");
+	assert_invalid("2018-10-06T22:20:00+1");
+	assert_invalid("2018-10-06T22:20:00+01:");
+	assert_invalid("2018-10-06T22:20:00Zulu");
+	assert_invalid("2018-10-06T22:20:00 ");
+	assert_invalid("x2018-10-06");
+    }
+}
@@ -1,6 +1,10 @@
 #include <value.h>
 
 #include <orchis.h>
+#include <cstring>
+#include <cstdio>
+#include <random>
+#include <cmath>
 
 namespace {
 
@@ -66,5 +70,91 @@ namespace value {
 	    assert_eq({p, p+5}, {-59.9});
 	    assert_eq({p, p+6}, {-60.0});
 	}
+
+	void from_text(TC)
+	{
+	    auto value = [] (const char* s) {
+			     return Value{s, s + std::strlen(s)};
+			 };
+	    assert_eq(value("6.7"), {6.7});
+	    assert_eq(value("135"), {135.0});
+	    assert_eq(value("-6.69"), {-6.7});
+	    assert_eq(value("02.49"), {2.5});
+	    assert_eq(value("03.400"), {3.4});
+	    assert_eq(value("0.05"), {0.1});
+	    assert_eq(value("-0.05"), {-0.1});
+	    assert_eq(value("0.0499"), {0.0});
+	    assert_eq(value("+3."), {3.0});
+	    assert_eq(value(" 3"), {3.0});
+	    assert_eq(value(".5"), {0.5});
+	    assert_eq(value(""), {0.0});
+	    assert_eq(value("-"), {0.0});
+	    assert_eq(value("foo"), {0.0});
+	    assert_eq(value("1.5foo"), {1.5});
+	}
+    }
+
+    namespace format {
+
+	std::string fixed(double n)
+	{
+	    char buf[40];
+	    const size_t len = fixed1(buf, sizeof buf, n);
+	    orchis::assert_eq(std::strlen(buf), len);
+	    return buf;
+	}
+
+	std::string printf(double n)
+	{
+	    char buf[40];
+	    std::snprintf(buf, sizeof buf, "%.1f", n);
+	    return buf;
+	}
+
+	void value(TC)
+	{
+	    char buf[20];
+	    orchis::assert_eq(Value{-14.4}.format(buf, sizeof buf), 5);
+	    orchis::assert_eq(std::string{buf}, "-14.4");
+	    orchis::assert_eq(Value{-0.4}.format(buf, sizeof buf), 4);
+	    orchis::assert_eq(std::string{buf}, "-0.4");
+	    orchis::assert_eq(Value{0.0}.format(buf, sizeof buf), 3);
+	    orchis::assert_eq(std::string{buf}, "0.0");
+	    orchis::assert_eq(Value{1234.5}.format(buf, 4), 3);
+	    orchis::assert_eq(std::string{buf}, "123");
+	}
+
+	void ties(TC)
+	{
+	    for(double n : {0.0, -0.0, 0.05, 0.15, 0.25, 0.35, -0.25, -0.04,
+			    -0.05, 2.45, 1e13 + 0.25, 0.95, 9.95, 99.95,
+			    1e15, -1e300, 1.0/3}) {
+		orchis::assert_eq(fixed(n), printf(n));
+	    }
+	    for(int i = -20000; i < 20000; i++) {
+		orchis::assert_eq(fixed(i / 100.0), printf(i / 100.0));
+		orchis::assert_eq(fixed(i / 20.0), printf(i / 20.0));
+	    }
+	}
+
+	void random(TC)
+	{
+	    std::mt19937_64 gen{4711};
+	    std::uniform_real_distribution<double> plot{-100, 1000};
+	    std::uniform_real_distribution<double> exp{-20, 14};
+	    for(int i = 0; i < 100000; i++) {
+		const double n = plot(gen);
+		orchis::assert_eq(fixed(n), printf(n));
+		const double m = std::pow(10, exp(gen)) * (i%2 ? -1 : 1);
+		orchis::assert_eq(fixed(m), printf(m));
+	    }
+	}
+
+	void truncated(TC)
+	{
+	    char buf[5];
+	    orchis::assert_eq(fixed1(buf, sizeof buf, -123.45), 4);
+	    orchis::assert_eq(std::string{buf}, "-123");
+	}
     }
 }
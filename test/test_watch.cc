@@ -0,0 +1,131 @@
+#include <watch.h>
+
+#include <orchis.h>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <poll.h>
+
+namespace {
+
+    std::set<std::string> weeks(const std::string& s)
+    {
+	return Watch::weeks(s.data(), s.data() + s.size());
+    }
+
+    std::string str(const std::set<std::string>& ss)
+    {
+	std::string acc;
+	for(const auto& s : ss) acc += s + ' ';
+	return acc;
+    }
+
+    /**
+     * A temporary directory, removed with its files afterwards.
+     */
+    struct Tmp {
+	Tmp()
+	{
+	    char tmpl[] = "/tmp/test_watch.XXXXXX";
+	    name = mkdtemp(tmpl);
+	}
+	~Tmp()
+	{
+	    std::remove((name + "/foo").c_str());
+	    std::remove((name + "/bar").c_str());
+	    rmdir(name.c_str());
+	}
+	std::string name;
+    };
+
+    void append(const std::string& path, const std::string& s)
+    {
+	std::ofstream os {path, std::ios::app};
+	os << s;
+    }
+
+    std::vector<Watch::Change> changes(Watch& watch)
+    {
+	pollfd pfd {watch.fd(), POLLIN, 0};
+	poll(&pfd, 1, 1000);
+	return watch.read();
+    }
+}
+
+namespace watch {
+
+    using orchis::TC;
+    using orchis::assert_eq;
+    using orchis::assert_true;
+    using orchis::assert_false;
+
+    void scan(TC)
+    {
+	assert_eq(str(weeks("")), "");
+	assert_eq(str(weeks("date: 2018-11-19T00:00:00\n"
+			    "temperature.air: 8.4\n"
+			    "date: 2018-11-25T23:59:00\n")), "2018-11-19 ");
+	assert_eq(str(weeks("date: 2018-11-26T00:00:00\n"
+			    "wind.force: 2.5\n"
+			    "date: 2018-11-18T12:00:00\n"
+			    "date: 2018-11-25T12:00:00")), "2018-11-12 2018-11-19 2018-11-26 ");
+    }
+
+    void ignored(TC)
+    {
+	assert_eq(str(weeks("\n"
+			    "temperature.air: 8.4\n"
+			    "date: yesterday\n"
+			    "# date: 2018-11-19T00:00:00\n"
+			    "dated: 2018-11-19T00:00:00\n")), "");
+    }
+
+    void grow(TC)
+    {
+	Tmp tmp;
+	const std::string foo = tmp.name + "/foo";
+	append(foo, "date: 2018-11-19T00:00:00\n");
+
+	Watch watch {{foo, tmp.name + "/bar"}};
+	assert_eq(watch.error(), 0);
+
+	append(foo, "temperature.air: 8.4\n"
+		    "date: 2018-11-26T00:00:00\n"
+		    "temperature.air: 8.4\n"
+		    "date: 2018-12-03T");
+	auto v = changes(watch);
+	assert_eq(v.size(), 1);
+	assert_eq(v[0].file, 0);
+	assert_false(v[0].all);
+	assert_eq(str(v[0].weeks), "2018-11-26 ");
+
+	append(foo, "00:00:00\n");
+	v = changes(watch);
+	assert_eq(v.size(), 1);
+	assert_eq(str(v[0].weeks), "2018-12-03 ");
+    }
+
+    void replace(TC)
+    {
+	Tmp tmp;
+	const std::string foo = tmp.name + "/foo";
+	const std::string bar = tmp.name + "/bar";
+	append(foo, "date: 2018-11-19T00:00:00\n");
+
+	Watch watch {{foo, bar}};
+	append(bar, "date: 2018-11-19T00:00:00\n");
+	auto v = changes(watch);
+	assert_eq(v.size(), 1);
+	assert_eq(v[0].file, 1);
+	assert_true(v[0].all);
+
+	append(tmp.name + "/baz", "date: 2018-11-26T00:00:00\n");
+	std::rename((tmp.name + "/baz").c_str(), foo.c_str());
+	v = changes(watch);
+	assert_eq(v.size(), 1);
+	assert_eq(v[0].file, 0);
+	assert_true(v[0].all);
+    }
+}
@@ -1,4 +1,5 @@
 #include <week.h>
+#include <timestamp.h>
 
 #include <orchis.h>
 #include <sstream>
@@ -90,6 +91,22 @@ namespace week {
 	assert_about( 2, "2018-10-29T00:00:00");
     }
 
+    void contains(orchis::TC)
+    {
+	const Week w{wed};
+	const Week p = w.prev();
+	orchis::assert_true(w.contains(wed));
+	orchis::assert_false(p.contains(wed));
+
+	std::time_t monday;
+	timestamp::parse("2018-10-15T00:00:00", monday);
+	orchis::assert_eq(w.scale(monday), w.scale("2018-10-15T00:00:00"));
+	orchis::assert_eq(w.scale(monday), 0);
+	orchis::assert_true(w.contains(monday));
+	orchis::assert_true(p.contains(monday));
+	orchis::assert_false(w.contains(monday - 1));
+    }
+
     void prev(orchis::TC)
     {
 	const Week w = Week{wed}.prev();
@@ -107,4 +124,11 @@ namespace week {
 	assert_fmt(Week{"2018-04-30"}, "30.4" + dash + "6.5.2018");
 	assert_fmt(Week{"2019-01-01"}, "31.12.2018" + dash + "6.1.2019");
     }
+
+    void strftime(orchis::TC)
+    {
+	orchis::assert_eq(Week{wed}.format("%G-W%V"), "2018-W42");
+	orchis::assert_eq(Week{"2019-01-01"}.format("%G-W%V.svg"), "2019-W01.svg");
+	orchis::assert_eq(Week{"2019-01-01"}.format("%Y-%m-%d"), "2018-12-31");
+    }
 }
@@ -6,6 +6,8 @@
 
 #include <orchis.h>
 #include <fstream>
+#include <type_traits>
+#include <cstdio>
 
 using orchis::TC;
 
@@ -127,6 +129,69 @@ namespace stream {
 		   "</foo>");
     }
 
+    /* Element names are only referred to, so they can't be made from
+     * a pointer which might dangle.
+     */
+    static_assert(!std::is_constructible<elem, const char*>::value, "");
+    static_assert(!std::is_constructible<elem, std::string>::value, "");
+
+    void formatted(TC)
+    {
+	std::ostringstream ss;
+	xml::ostream xs(ss);
+	xs << elem("foo")
+	   << attr::formatted("bar", [] (char* buf, size_t size) {
+				  return size_t(std::snprintf(buf, size, "%d&%d", 1, 2));
+			      })
+	   << end;
+
+	assert_xml(ss,
+		   "<foo\n"
+		   "  bar='1&amp;2'/>");
+    }
+
+    void fragment(TC)
+    {
+	xml::fragment a;
+	xml::fragment b;
+	{
+	    std::ostringstream ss;
+	    xml::ostream xs(ss);
+	    xs << elem("foo") << attr("bar", "baz");
+	    xs.record(a);
+	    xs << elem("bat") << "x" << end;
+	    xs.stop(a);
+	    xs << elem("bat") << end;
+	    xs.record(b);
+	    xs << elem("baz") << attr("u", "v") << end;
+	    xs.stop(b);
+	    xs << end;
+	}
+
+	std::ostringstream ss;
+	xml::ostream xs(ss);
+	xs << elem("foo") << attr("bar", "1")
+	   << a
+	   << elem("bat") << attr("u", "w") << end
+	   << b
+	   << b
+	   << end;
+
+	assert_xml(ss,
+		   "<foo\n"
+		   "  bar='1'>\n"
+		   "  <bat>\n"
+		   "    x\n"
+		   "  </bat>\n"
+		   "  <bat\n"
+		   "    u='w'/>\n"
+		   "  <baz\n"
+		   "    u='v'/>\n"
+		   "  <baz\n"
+		   "    u='v'/>\n"
+		   "</foo>");
+    }
+
     namespace indent {
 
 	void simple(TC)
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "timestamp.h"
+
+#include <vector>
+#include <algorithm>
+#include <time.h>
+
+using std::time_t;
+
+namespace {
+
+    /**
+     * Days since 1970-01-01 for a date in the proleptic Gregorian
+     * calendar.  From Howard Hinnant's "chrono-Compatible Low-Level
+     * Date Algorithms".
+     */
+    long days_from_civil(long y, unsigned m, unsigned d)
+    {
+	y -= m <= 2;
+	const long era = (y >= 0 ? y : y-399) / 400;
+	const unsigned yoe = y - era * 400;
+	const unsigned doy = (153*(m > 2 ? m-3 : m+9) + 2)/5 + d-1;
+	const unsigned doe = yoe * 365 + yoe/4 - yoe/100 + doy;
+	return era * 146097 + long(doe) - 719468;
+    }
+
+    long gmtoff(time_t t)
+    {
+	std::tm tm;
+	localtime_r(&t, &tm);
+	return tm.tm_gmtoff;
+    }
+
+    /**
+     * The local timezone's UTC offsets between 1970 and 2100, as a
+     * list of transitions.  Found by sampling once a week, and
+     * bisecting to the exact second when the offset has changed.
+     * Outside that range we ask localtime(3).
+     */
+    class Zone {
+    public:
+	Zone();
+	time_t utc(time_t local) const;
+
+    private:
+	long offset(time_t t) const;
+
+	struct Transition {
+	    time_t t;
+	    long offset;
+	    bool operator< (time_t other) const { return t < other; }
+	};
+	std::vector<Transition> v;
+	time_t lo;
+	time_t hi;
+    };
+
+    Zone::Zone()
+	: lo{0},
+	  hi{days_from_civil(2100, 1, 1) * 86400}
+    {
+	tzset();
+	const time_t week = 7 * 86400;
+	long prev = gmtoff(lo);
+	v.push_back({lo, prev});
+
+	for(time_t t = lo + week; t < hi; t += week) {
+	    const long off = gmtoff(t);
+	    if(off==prev) continue;
+
+	    time_t a = t - week;
+	    time_t b = t;
+	    while(b - a > 1) {
+		const time_t mid = a + (b - a)/2;
+		if(gmtoff(mid)==prev) a = mid;
+		else b = mid;
+	    }
+	    v.push_back({b, gmtoff(b)});
+	    prev = off;
+	}
+    }
+
+    long Zone::offset(time_t t) const
+    {
+	if(t < lo || t >= hi) return gmtoff(t);
+	auto it = std::lower_bound(begin(v), end(v), t+1);
+	return (--it)->offset;
+    }
+
+    /**
+     * The time_t for a local time, expressed as if it was UTC.  In the
+     * ambiguous hour when DST ends, we pick the earlier time.  In the
+     * nonexistent hour when DST starts, the time is taken to be
+     * standard time, so that 02:30 becomes 03:30 DST.
+     */
+    time_t Zone::utc(time_t local) const
+    {
+	const long before = offset(local - 86400);
+	const long after = offset(local + 86400);
+	if(before==after) return local - before;
+
+	const time_t a = local - before;
+	const time_t b = local - after;
+	const bool va = offset(a)==before;
+	const bool vb = offset(b)==after;
+	if(va && vb) return std::min(a, b);
+	if(vb) return b;
+	return a;
+    }
+
+    const Zone& zone()
+    {
+	static const Zone z;
+	return z;
+    }
+
+    bool isdigit(char ch)
+    {
+	return '0' <= ch && ch <= '9';
+    }
+
+    /**
+     * Parse exactly n digits from a, leaving a after them.
+     */
+    bool digits(const char*& a, const char* b, unsigned n, unsigned& val)
+    {
+	if(b - a < long(n)) return false;
+	val = 0;
+	while(n--) {
+	    if(!isdigit(*a)) return false;
+	    val = val*10 + (*a++ - '0');
+	}
+	return true;
+    }
+
+    bool expect(const char*& a, const char* b, char ch)
+    {
+	if(a==b || *a != ch) return false;
+	a++;
+	return true;
+    }
+
+    /**
+     * Parse an offset from UTC: Z, +hh:mm, +hhmm or +hh.
+     */
+    bool offset(const char*& a, const char* b, long& off)
+    {
+	if(expect(a, b, 'Z')) {
+	    off = 0;
+	    return true;
+	}
+	int sign;
+	if(expect(a, b, '+')) sign = 1;
+	else if(expect(a, b, '-')) sign = -1;
+	else return false;
+
+	unsigned hh;
+	unsigned mm = 0;
+	if(!digits(a, b, 2, hh)) return false;
+	if(a!=b) {
+	    expect(a, b, ':');
+	    if(!digits(a, b, 2, mm)) return false;
+	}
+	if(hh > 23 || mm > 59) return false;
+	off = sign * long(hh*3600 + mm*60);
+	return true;
+    }
+}
+
+
+/**
+ * Parse [a, b) into t.  Returns false, and leaves t alone, unless
+ * all of it is a valid timestamp.
+ */
+bool timestamp::parse(const char* a, const char* b, time_t& t)
+{
+    unsigned y, m, d;
+    unsigned hh = 0, mm = 0, ss = 0;
+
+    if(!(digits(a, b, 4, y) && expect(a, b, '-') &&
+	 digits(a, b, 2, m) && expect(a, b, '-') &&
+	 digits(a, b, 2, d))) return false;
+    if(m < 1 || m > 12 || d < 1 || d > 31) return false;
+
+    if(a!=b && (*a=='T' || *a==' ')) {
+	a++;
+	if(!(digits(a, b, 2, hh) && expect(a, b, ':') &&
+	     digits(a, b, 2, mm))) return false;
+	if(expect(a, b, ':')) {
+	    if(!digits(a, b, 2, ss)) return false;
+	    if(expect(a, b, '.') || expect(a, b, ',')) {
+		if(a==b || !isdigit(*a)) return false;
+		while(a!=b && isdigit(*a)) a++;
+	    }
+	}
+	if(hh > 24 || mm > 59 || ss > 60) return false;
+    }
+
+    const time_t local = days_from_civil(y, m, d) * 86400
+			 + hh*3600 + mm*60 + ss;
+    if(a==b) {
+	t = zone().utc(local);
+	return true;
+    }
+
+    long off;
+    if(!offset(a, b, off) || a!=b) return false;
+    t = local - off;
+    return true;
+}
@@ -0,0 +1,59 @@
+/* -*- c++ -*-
+ *
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WEATHER_TIMESTAMP_H
+#define WEATHER_TIMESTAMP_H
+
+#include <ctime>
+#include <string>
+
+/**
+ * Parsing the ISO 8601 timestamps in weather(5) into time_t:
+ *
+ *   2022-11-27T23:05:03.001+01:00
+ *   2022-11-27T23:05:03Z
+ *   2018-10-06T22:20:00
+ *   2018-10-06
+ *
+ * Fractions of a second are ignored.  An explicit offset from UTC is
+ * honored; without one, local time is implied.  Unlike mktime(3),
+ * this doesn't consult the timezone database for every timestamp:
+ * the local UTC offsets are collected into a table once, the first
+ * time they're needed.
+ */
+namespace timestamp {
+
+    bool parse(const char* a, const char* b, std::time_t& t);
+
+    inline
+    bool parse(const std::string& s, std::time_t& t)
+    {
+	return parse(s.data(), s.data() + s.size(), t);
+    }
+}
+
+#endif
@@ -29,6 +29,7 @@
 #define WEATHER_VALUE_H
 
 #include <iosfwd>
+#include <cstddef>
 
 /**
  * A sample value. Since all sampled values (wind, temperature) are
@@ -39,6 +40,8 @@
  * int.
  *
  * Includes conversion to and from double and strings like "-14.4".
+ * The formatting is also available on its own, for doubles, as
+ * fixed1().
  */
 class Value {
 public:
@@ -54,11 +57,14 @@ public:
     bool operator! () const { return !repr; }
 
     std::ostream& put(std::ostream& os) const;
+    size_t format(char* buf, size_t size) const;
 
 private:
     int repr;
 };
 
+size_t fixed1(char* buf, size_t size, double n);
+
 inline
 std::ostream& operator<< (std::ostream& os, const Value& val)
 {
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "watch.h"
+
+#include "week.h"
+#include "field.h"
+#include "timestamp.h"
+
+#include <algorithm>
+#include <map>
+#include <cerrno>
+
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+    const std::uint32_t mask = IN_MODIFY | IN_CLOSE_WRITE |
+			       IN_CREATE | IN_DELETE |
+			       IN_MOVED_FROM | IN_MOVED_TO;
+
+    std::string dirname(const std::string& path)
+    {
+	const size_t n = path.rfind('/');
+	if(n==std::string::npos) return ".";
+	if(n==0) return "/";
+	return path.substr(0, n);
+    }
+
+    std::string basename(const std::string& path)
+    {
+	const size_t n = path.rfind('/');
+	if(n==std::string::npos) return path;
+	return path.substr(n + 1);
+    }
+
+    /**
+     * The offset just after the last complete line of the file,
+     * looking no further back than a reasonable line length.
+     */
+    off_t last_line(int fd, off_t size)
+    {
+	char buf[8192];
+	const off_t a = std::max<off_t>(size - off_t(sizeof buf), 0);
+	const ssize_t n = pread(fd, buf, size - a, a);
+	if(n <= 0) return size;
+	const char* nl = std::find(std::reverse_iterator<const char*>(buf + n),
+				   std::reverse_iterator<const char*>(buf),
+				   '\n').base();
+	if(nl==buf) return a ? size : 0;
+	return a + (nl - buf);
+    }
+}
+
+
+/**
+ * Start watching the files.  They don't have to exist yet.  If a
+ * directory cannot be watched, error() says why.
+ */
+Watch::Watch(const std::vector<std::string>& paths)
+    : ifd{inotify_init1(IN_NONBLOCK | IN_CLOEXEC)}
+{
+    if(ifd==-1) {
+	err = errno;
+	return;
+    }
+
+    std::map<std::string, int> dirs;
+    for(const auto& path : paths) {
+	const std::string dir = dirname(path);
+	auto it = dirs.find(dir);
+	if(it==dirs.end()) {
+	    const int wd = inotify_add_watch(ifd, dir.c_str(), mask);
+	    if(wd==-1) err = errno;
+	    it = dirs.insert({dir, wd}).first;
+	}
+	files.push_back({path, basename(path), it->second, 0, 0});
+	stat(files.back());
+    }
+}
+
+Watch::~Watch()
+{
+    if(ifd!=-1) close(ifd);
+}
+
+/**
+ * Note the version of the file as it is now, and where its complete
+ * lines end.
+ */
+void Watch::stat(File& f)
+{
+    f.inode = 0;
+    f.known = 0;
+    const int fd = open(f.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd==-1) return;
+    struct stat st;
+    if(!fstat(fd, &st)) {
+	f.inode = st.st_ino;
+	f.known = last_line(fd, st.st_size);
+    }
+    close(fd);
+}
+
+/**
+ * What has changed in the n:th file since last time.
+ */
+Watch::Change Watch::check(unsigned n)
+{
+    File& f = files[n];
+    Change change {n, true, {}};
+
+    const int fd = open(f.path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if(fd==-1 || fstat(fd, &st)) {
+	if(fd!=-1) close(fd);
+	f.inode = 0;
+	f.known = 0;
+	return change;
+    }
+    if(st.st_ino!=f.inode || st.st_size < f.known) {
+	f.inode = st.st_ino;
+	f.known = last_line(fd, st.st_size);
+	close(fd);
+	return change;
+    }
+
+    std::string buf(st.st_size - f.known, '\0');
+    const ssize_t len = pread(fd, &buf[0], buf.size(), f.known);
+    close(fd);
+    if(len < 0) return change;
+    buf.resize(len);
+
+    change.all = false;
+    const size_t nl = buf.rfind('\n');
+    if(nl==std::string::npos) return change;
+    change.weeks = weeks(buf.data(), buf.data() + nl + 1);
+    f.known += nl + 1;
+    return change;
+}
+
+/**
+ * Call when fd() is readable.  Returns the files which have changed,
+ * in some way which matters.
+ */
+std::vector<Watch::Change> Watch::read()
+{
+    std::set<unsigned> changed;
+    alignas(inotify_event) char buf[4096];
+    ssize_t n;
+    while((n = ::read(ifd, buf, sizeof buf)) > 0) {
+	const char* p = buf;
+	while(p < buf + n) {
+	    const auto ev = reinterpret_cast<const inotify_event*>(p);
+	    p += sizeof *ev + ev->len;
+	    for(unsigned i = 0; i < files.size(); i++) {
+		const File& f = files[i];
+		if(ev->mask & IN_Q_OVERFLOW ||
+		   (f.wd==ev->wd && ev->len && f.name==ev->name)) changed.insert(i);
+	    }
+	}
+    }
+
+    std::vector<Change> v;
+    for(unsigned i : changed) {
+	Change change = check(i);
+	if(change.all || change.weeks.size()) v.push_back(change);
+    }
+    return v;
+}
+
+/**
+ * The weeks (Mondays) of the samples in the weather(5) lines [a, b).
+ */
+std::set<std::string> Watch::weeks(const char* a, const char* b)
+{
+    std::set<std::string> acc;
+    while(a!=b) {
+	const char* nl = std::find(a, b, '\n');
+	field::Field f;
+	std::time_t t;
+	if(field::split(f, a, nl)==field::Kind::field &&
+	   field::is(f, "date") &&
+	   timestamp::parse(f.val, f.val_end, t)) {
+	    acc.insert(Week{t}.monday());
+	}
+	a = nl==b ? b : nl + 1;
+    }
+    return acc;
+}
@@ -0,0 +1,90 @@
+/* -*- c++ -*-
+ *
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef WEATHER_WATCH_H
+#define WEATHER_WATCH_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <cstdint>
+#include <sys/types.h>
+
+/**
+ * Watching a set of weather(5) files with inotify(7), to find out
+ * which weeks of them have changed.
+ *
+ * It's the directories which are watched, so that a file which is
+ * replaced by rename(2) (as weather_compact(1) does it) is noticed
+ * as well as one which is appended to (as weather(1) does it).
+ *
+ * When a file has only grown, the new lines are read, and the weeks
+ * of their samples are the ones which changed.  Otherwise, for
+ * example if it has been replaced or removed, all weeks have.
+ */
+class Watch {
+public:
+    explicit Watch(const std::vector<std::string>& paths);
+    ~Watch();
+    Watch(const Watch&) = delete;
+    Watch& operator= (const Watch&) = delete;
+
+    int fd() const { return ifd; }
+    int error() const { return err; }
+
+    /**
+     * A file which has changed, as its index among the paths, and
+     * either the Mondays of the weeks which changed, or all.
+     */
+    struct Change {
+	unsigned file;
+	bool all;
+	std::set<std::string> weeks;
+    };
+
+    std::vector<Change> read();
+
+    static std::set<std::string> weeks(const char* a, const char* b);
+
+private:
+    struct File {
+	std::string path;
+	std::string name;
+	int wd;
+	std::uint64_t inode;
+	off_t known;
+    };
+
+    void stat(File& f);
+    Change check(unsigned n);
+
+    std::vector<File> files;
+    int ifd;
+    int err = 0;
+};
+
+#endif
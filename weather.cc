@@ -26,7 +26,7 @@
  */
 #include <string>
 #include <iostream>
-#include <fstream>
+#include <sstream>
 #include <vector>
 #include <cstring>
 #include <cstdlib>
@@ -42,6 +42,9 @@
 #include "duration.h"
 #include "socket.h"
 #include "tlsclient.h"
+#include "append.h"
+#include "snapshot.h"
+#include "rollupfile.h"
 
 
 namespace {
@@ -176,49 +179,85 @@ namespace {
 	return weather(acc, cerr, timeout, duration, key, stations);
     }
 
+    bool append_to(const Append& append,
+		   const std::string& file, const std::string& buf)
+    {
+	if(append(file, buf)) return true;
+	std::cerr << "cannot append to '" << file << "': "
+		  << std::strerror(errno) << '\n';
+	return false;
+    }
+
     /**
-     * Fetch the data and print it to 'os' (with an optional prefix
-     * separating it from earlier entries in the file).  Returns an
-     * exit code, and may print error messages to stderr.
+     * Update the rollup for 'station' in 'dir', if there is a 'dir',
+     * by appending the hours and days which the samples changed.
      */
-    int weather(std::ostream& os, const char* prefix,
-		double timeout,
-		const Duration& duration,
-		const std::string& key,
-		const std::string& station)
+    bool update_rollup(const std::string& dir,
+		       const std::string& station, const Samples& series,
+		       const Append& append)
     {
-	std::unordered_map<std::string, Samples> samples;
-	if(!weather(samples, std::cerr, timeout, duration, key, station)) return 1;
+	if(dir.empty()) return true;
+	return append_rollup(dir + "/" + station, series, append, std::cerr);
+    }
 
-	const auto& series = samples[station];
-	if(series.empty()) {
-	    std::cerr << "error: response contained no data for '"
-		      << station << "'\n";
-	    return 1;
-	}
+    /**
+     * Update the snapshot for 'station' in 'dir', if there is a 'dir'.
+     */
+    bool update_snapshot(const std::string& dir,
+			 const std::string& station, const Samples& series)
+    {
+	if(dir.empty()) return true;
+	return snapshot(dir + "/" + station, series, std::cerr);
+    }
 
-	render(os, prefix, series);
-	return 0;
+    /**
+     * Update the snapshot and rollup for 'station', once its samples
+     * are safely written.  Returns success, printing errors to
+     * stderr.
+     */
+    bool update_derived(const std::string& snapdir,
+			const std::string& rolldir,
+			const std::string& station, const Samples& series,
+			const Append& append)
+    {
+	bool ok = update_snapshot(snapdir, station, series);
+	if(!update_rollup(rolldir, station, series, append)) ok = false;
+	return ok;
     }
 
     /**
      * Fetch the data for 'station' and either append it to 'file' or
-     * print it to stdout.  Return an exit code.
+     * print it to stdout, and then update the derived files.  Return
+     * an exit code.
      */
     int weather(double timeout,
 		const Duration& duration,
 		const std::string& key,
 		const std::string& station,
-		const std::string& file)
+		const std::string& file,
+		const Append& append,
+		const std::string& snapdir,
+		const std::string& rolldir)
     {
-	if(file.empty()) return weather(std::cout, "", timeout, duration, key, station);
-	std::ofstream os(file, std::ios::app);
-	if(!os) {
-	    std::cerr << "cannot open '" << file << "' for writing: "
-		      << std::strerror(errno) << '\n';
+	std::unordered_map<std::string, Samples> samples;
+	if(!weather(samples, std::cerr, timeout, duration, key, station)) return 1;
+
+	const auto& series = samples[station];
+	if(series.empty()) {
+	    std::cerr << "error: response contained no data for '"
+		      << station << "'\n";
 	    return 1;
 	}
-	return weather(os, "\n", timeout, duration, key, station);
+
+	if(file.empty()) {
+	    render(std::cout, "", series);
+	}
+	else {
+	    std::ostringstream os;
+	    render(os, "\n", series);
+	    if(!append_to(append, file, os.str())) return 1;
+	}
+	return update_derived(snapdir, rolldir, station, series, append) ? 0 : 1;
     }
 
     /**
@@ -229,7 +268,10 @@ namespace {
 		const Duration& duration,
 		const std::string& key,
 		const std::string& dir,
-		const std::vector<std::string>& stations)
+		const std::vector<std::string>& stations,
+		const Append& append,
+		const std::string& snapdir,
+		const std::string& rolldir)
     {
 	std::unordered_map<std::string, Samples> samples;
 	if(!weather(samples, std::cerr, timeout, duration, key, stations)) return 1;
@@ -238,15 +280,20 @@ namespace {
 			return dir + "/" + station;
 		    };
 
+	int rc = 0;
 	for(const auto& val: samples) {
 	    const auto& station = val.first;
 	    const auto& series = val.second;
 
-	    std::ofstream os(path(station), std::ios::app);
+	    std::ostringstream os;
 	    render(os, "\n", series);
-	    os.close();
+	    if(!append_to(append, path(station), os.str())) {
+		rc = 1;
+		continue;
+	    }
+	    if(!update_derived(snapdir, rolldir, station, series, append)) rc = 1;
 	}
-	return 0;
+	return rc;
     }
 }
 
@@ -255,16 +302,16 @@ int main(int argc, char ** argv)
 {
     const std::string prog = argv[0];
     const std::string usage = std::string("usage: ")
-	+ prog + " [-T seconds] [-h duration] -k key station\n"
+	+ prog + " [-T seconds] [-h duration] [-N dir] [-R dir] -k key station\n"
 	"       "
-	+ prog + " [-T seconds] [-h duration] -k key station file\n"
+	+ prog + " [-T seconds] [-h duration] [-l] [-s sync] [-N dir] [-R dir] -k key station file\n"
 	"       "
-	+ prog + " [-T seconds] [-h duration] -k key -C dir station ...\n"
+	+ prog + " [-T seconds] [-h duration] [-l] [-s sync] [-N dir] [-R dir] -k key -C dir station ...\n"
 	"       "
 	+ prog + " --help\n"
 	"       "
 	+ prog + " --version";
-    const char optstring[] = "T:h:k:C:";
+    const char optstring[] = "T:h:k:C:ls:N:R:";
     const struct option long_options[] = {
 	{"help", 0, 0, 'H'},
 	{"version", 0, 0, 'V'},
@@ -278,6 +325,10 @@ int main(int argc, char ** argv)
     Duration duration {"1h"};
     std::string key;
     std::string dir;
+    std::string snapdir;
+    std::string rolldir;
+    bool lock = false;
+    Append::Sync sync = Append::Sync::none;
 
     int ch;
     while((ch = getopt_long(argc, argv,
@@ -302,6 +353,25 @@ int main(int argc, char ** argv)
 	case 'C':
 	    dir = optarg;
 	    break;
+	case 'l':
+	    lock = true;
+	    break;
+	case 'N':
+	    snapdir = optarg;
+	    break;
+	case 'R':
+	    rolldir = optarg;
+	    break;
+	case 's':
+	    if(!std::strcmp(optarg, "none")) sync = Append::Sync::none;
+	    else if(!std::strcmp(optarg, "data")) sync = Append::Sync::data;
+	    else if(!std::strcmp(optarg, "full")) sync = Append::Sync::full;
+	    else {
+		std::cerr << "error: bad -s argument\n"
+			  << usage << '\n';
+		return 1;
+	    }
+	    break;
 	case 'H':
 	    std::cout << usage << '\n';
 	    return 0;
@@ -352,9 +422,11 @@ int main(int argc, char ** argv)
 	    station = args[0];
 	}
 
-	return weather(timeout, duration, key, station, file);
+	return weather(timeout, duration, key, station, file,
+		       Append{lock, sync}, snapdir, rolldir);
     }
     else {
-	return weather(timeout, duration, key, dir, args);
+	return weather(timeout, duration, key, dir, args,
+		       Append{lock, sync}, snapdir, rolldir);
     }
 }
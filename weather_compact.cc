@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <string>
+#include <iostream>
+#include <streambuf>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+
+#include <getopt.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+
+#include "compact.h"
+#include "atomic.h"
+#include "rollup.h"
+#include "files...h"
+
+
+namespace {
+
+    /**
+     * A read-only streambuf for the bytes [begin, end) of a file,
+     * so we can ignore anything appended after we started.  If they
+     * cannot all be read, it ends early and error() is set to the
+     * errno; the stream cannot tell that from the end of the data.
+     */
+    class Limited : public std::streambuf {
+    public:
+	Limited(int fd, off_t begin, off_t end)
+	    : fd{fd},
+	      pos{begin},
+	      end{end}
+	{}
+
+	int error() const { return err; }
+
+    protected:
+	int_type underflow() override
+	{
+	    if(gptr() < egptr()) return traits_type::to_int_type(*gptr());
+	    const size_t n = std::min(off_t(sizeof buf), end - pos);
+	    if(!n) return traits_type::eof();
+	    const ssize_t m = pread(fd, buf, n, pos);
+	    if(m <= 0) {
+		err = m ? errno : EIO;
+		return traits_type::eof();
+	    }
+	    pos += m;
+	    setg(buf, buf, buf + m);
+	    return traits_type::to_int_type(*gptr());
+	}
+
+    private:
+	const int fd;
+	off_t pos;
+	const off_t end;
+	int err = 0;
+	char buf[64 * 1024];
+    };
+
+    std::string dirname(const std::string& path)
+    {
+	const auto n = path.rfind('/');
+	if(n==std::string::npos) return ".";
+	if(n==0) return "/";
+	return path.substr(0, n);
+    }
+
+    /**
+     * The file's size, taken while holding the advisory lock, so that
+     * a well-behaved appender is not in the middle of a write.
+     */
+    off_t locked_size(int fd)
+    {
+	flock(fd, LOCK_EX);
+	struct stat st;
+	fstat(fd, &st);
+	flock(fd, LOCK_UN);
+	return st.st_size;
+    }
+
+    std::string basename(const std::string& path)
+    {
+	const auto n = path.rfind('/');
+	if(n==std::string::npos) return path;
+	return path.substr(n+1);
+    }
+
+    bool same_file(int fd, const std::string& path)
+    {
+	struct stat a;
+	struct stat b;
+	if(fstat(fd, &a) || stat(path.c_str(), &b)) return false;
+	return a.st_dev==b.st_dev && a.st_ino==b.st_ino;
+    }
+
+    /**
+     * Compact 'file' in place.  Data appended while we work is copied
+     * as-is to the end of the new file, under the advisory lock, right
+     * before it replaces the old one.  Returns an exit code.
+     */
+    int compact_file(const std::string& file, size_t budget, bool verbose)
+    {
+	auto fail = [&file] (const std::string& msg) {
+			std::cerr << "error: '" << file << "': " << msg << '\n';
+			return 1;
+		    };
+
+	const int fd = open(file.c_str(), O_RDONLY);
+	if(fd==-1) return fail(std::strerror(errno));
+
+	const off_t size = locked_size(fd);
+	Limited src{fd, 0, size};
+	std::istream is{&src};
+
+	AtomicFile out{file};
+	if(!out) {
+	    close(fd);
+	    return fail(out.error());
+	}
+
+	compact::Stats stats;
+	if(!compact::compact(is, out.os(), budget, dirname(file), stats)) {
+	    close(fd);
+	    return fail(std::strerror(errno));
+	}
+	if(src.error()) {
+	    close(fd);
+	    return fail(std::strerror(src.error()));
+	}
+
+	flock(fd, LOCK_EX);
+	struct stat st;
+	fstat(fd, &st);
+	bool ok = false;
+	if(st.st_size < size || !same_file(fd, file)) {
+	    fail("modified by someone else; left alone");
+	}
+	else {
+	    Limited tail{fd, size, st.st_size};
+	    if(st.st_size > size) out.os() << &tail;
+	    if(tail.error()) {
+		fail(std::strerror(tail.error()));
+	    }
+	    else {
+		ok = out.commit();
+		if(!ok) fail(out.error());
+	    }
+	}
+	flock(fd, LOCK_UN);
+	close(fd);
+	if(!ok) return 1;
+
+	if(verbose) {
+	    std::cout << file << ": "
+		      << stats.records << " samples, "
+		      << stats.duplicates << " duplicates, "
+		      << stats.disorder << " out of order";
+	    if(stats.runs) std::cout << ", " << stats.runs << " runs";
+	    if(st.st_size > size) std::cout << ", "
+					    << st.st_size - size
+					    << " bytes appended meanwhile";
+	    std::cout << '\n';
+	}
+	return 0;
+    }
+
+    /**
+     * Rebuild the rollup dir/station from the (freshly compacted)
+     * weather(5) file.  Returns an exit code.
+     */
+    int rebuild_rollup(const std::string& file, const std::string& dir)
+    {
+	const std::string path = dir + "/" + basename(file);
+	const std::string* const p = &file;
+	Files files {p, p+1};
+	const Rollup rollup {files};
+
+	AtomicFile out {path};
+	if(out) {
+	    rollup.put(out.os());
+	    if(out.commit()) return 0;
+	}
+	std::cerr << "error: '" << path << "': " << out.error() << '\n';
+	return 1;
+    }
+}
+
+
+int main(int argc, char ** argv)
+{
+    const std::string prog = argv[0];
+    const std::string usage = std::string("usage: ")
+	+ prog + " [-v] [-m megabytes] [-R dir] file ...\n"
+	"       "
+	+ prog + " --help\n"
+	"       "
+	+ prog + " --version";
+    const char optstring[] = "vm:R:";
+    const struct option long_options[] = {
+	{"help", 0, 0, 'H'},
+	{"version", 0, 0, 'V'},
+	{0, 0, 0, 0}
+    };
+
+    std::cin.sync_with_stdio(false);
+    std::cout.sync_with_stdio(false);
+
+    bool verbose = false;
+    size_t budget = 64;
+    std::string rolldir;
+
+    int ch;
+    while((ch = getopt_long(argc, argv,
+			    optstring,
+			    &long_options[0], 0)) != -1) {
+	switch(ch) {
+	case 'v':
+	    verbose = true;
+	    break;
+	case 'm':
+	    char* end;
+	    budget = std::strtoul(optarg, &end, 10);
+	    if(end==optarg || *end || !budget) {
+		std::cerr << "error: incorrect -m argument\n"
+			  << usage << '\n';
+		return 1;
+	    }
+	    break;
+	case 'R':
+	    rolldir = optarg;
+	    break;
+	case 'H':
+	    std::cout << usage << '\n';
+	    return 0;
+	    break;
+	case 'V':
+	    std::cout << "weather_compact, part of Weather 4.1\n"
+		      << "Copyright (c) 2026 Jrgen Grahn\n";
+	    return 0;
+	    break;
+	case ':':
+	case '?':
+	default:
+	    std::cerr << usage << '\n';
+	    return 1;
+	    break;
+	}
+    }
+
+    const std::vector<std::string> files {argv+optind, argv+argc};
+    if(files.empty()) {
+	std::cerr << usage << '\n';
+	return 1;
+    }
+
+    int rc = 0;
+    for(const auto& file : files) {
+	int err = compact_file(file, budget * 1024 * 1024, verbose);
+	if(!err && rolldir.size()) err = rebuild_rollup(file, rolldir);
+	rc |= err;
+    }
+    return rc;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <string>
+#include <iostream>
+#include <cstring>
+
+#include <getopt.h>
+
+#include "rollup.h"
+#include "atomic.h"
+#include "files...h"
+
+
+int main(int argc, char ** argv)
+{
+    const std::string prog = argv[0];
+    const std::string usage = std::string("usage: ")
+	+ prog + " [-o rollup-file] file ...\n"
+	"       "
+	+ prog + " --help\n"
+	"       "
+	+ prog + " --version";
+    const char optstring[] = "o:";
+    const struct option long_options[] = {
+	{"help", 0, 0, 'H'},
+	{"version", 0, 0, 'V'},
+	{0, 0, 0, 0}
+    };
+
+    std::cin.sync_with_stdio(false);
+    std::cout.sync_with_stdio(false);
+
+    std::string out;
+
+    int ch;
+    while((ch = getopt_long(argc, argv,
+			    optstring,
+			    &long_options[0], 0)) != -1) {
+	switch(ch) {
+	case 'o':
+	    out = optarg;
+	    break;
+	case 'H':
+	    std::cout << usage << '\n';
+	    return 0;
+	    break;
+	case 'V':
+	    std::cout << "weather_rollup, part of Weather 4.1\n"
+		      << "Copyright (c) 2026 Jrgen Grahn\n";
+	    return 0;
+	    break;
+	case ':':
+	case '?':
+	default:
+	    std::cerr << usage << '\n';
+	    return 1;
+	    break;
+	}
+    }
+
+    Files files {argv+optind, argv+argc};
+    const Rollup rollup {files};
+
+    if(out.empty()) {
+	rollup.put(std::cout);
+	return 0;
+    }
+
+    AtomicFile file {out};
+    if(file) {
+	rollup.put(file.os());
+	if(file.commit()) return 0;
+    }
+    std::cerr << "cannot write '" << out << "': " << file.error() << '\n';
+    return 1;
+}
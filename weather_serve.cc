@@ -0,0 +1,591 @@
+/*
+ * Copyright (c) 2026 Jrgen Grahn
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <memory>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <cerrno>
+#include <csignal>
+
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "plot.h"
+#include "area.h"
+#include "week.h"
+#include "curves.h"
+#include "timestamp.h"
+#include "raster.h"
+#include "plotcache.h"
+#include "watch.h"
+#include "http.h"
+
+
+namespace {
+
+    /**
+     * How to plot, as for weather_week(1), and whether to log.
+     */
+    struct Options {
+	bool use_wind_direction = false;
+	WeekPlot::Thinning thin;
+	bool verbose = false;
+    };
+
+    /**
+     * A station: its name in URLs, and its file.
+     */
+    struct Station {
+	std::string name;
+	std::string path;
+    };
+
+    /**
+     * The name of the station in 'path': its base name, without
+     * extension.
+     */
+    std::string station_name(const std::string& path)
+    {
+	std::string s = path.substr(path.rfind('/') + 1);
+	const size_t dot = s.find('.');
+	if(dot && dot!=std::string::npos) s.resize(dot);
+	return s;
+    }
+
+    /**
+     * The week plot, as SVG or rasterized to PNG, like weather_week(1)
+     * would do it.
+     */
+    std::string render(const Week& when, const Options& opt,
+		       const Curves& curves, bool png)
+    {
+	std::ostringstream os;
+	{
+	    const Area temperature{{-20, +30}, {700, 200}};
+	    const SubArea rain{temperature, {0, 20}, 200 * 3/5};
+	    const Area wind{temperature, {0, 20}, 50};
+	    WeekPlot plot{os, when, temperature, rain, wind};
+	    plot.decimate(opt.thin.decimate);
+	    plot.simplify(opt.thin.tolerance);
+	    plot.plot(opt.use_wind_direction, curves);
+	}
+	if(!png) return os.str();
+
+	std::ostringstream pos;
+	raster::rasterize(os.str()).png(pos);
+	return pos.str();
+    }
+
+    /**
+     * A response: its header, and a body which may be shared with the
+     * PlotCache, or missing for HEAD requests.
+     */
+    struct Response {
+	std::string header;
+	PlotCache::Plot body;
+    };
+
+    /**
+     * The stations, the cache of their weeks, and the answers to
+     * requests about them.
+     */
+    class Server {
+    public:
+	Server(const std::vector<Station>& stations,
+	       const Options& opt, size_t limit)
+	    : stations{stations},
+	      opt(opt),
+	      cache{limit}
+	{}
+
+	Response get(const http::Request& req);
+	void changed(const std::vector<Watch::Change>& changes);
+
+    private:
+	Response respond(unsigned status, const char* type,
+			 const PlotCache::Plot& body,
+			 const http::Request& req);
+	Response plot(unsigned n, const std::string& when,
+		      const std::string& format,
+		      const http::Request& req);
+
+	const std::vector<Station> stations;
+	const Options opt;
+	PlotCache cache;
+    };
+
+    Response Server::respond(unsigned status, const char* type,
+			     const PlotCache::Plot& body,
+			     const http::Request& req)
+    {
+	if(opt.verbose) {
+	    std::cerr << req.method << ' ' << req.target << ' ' << status << '\n';
+	}
+	Response r;
+	r.header = http::header(status, type, body->size(), req.keep_alive);
+	if(req.method!="HEAD") r.body = body;
+	return r;
+    }
+
+    /**
+     * Answer a request: GET (or HEAD) of
+     *
+     *   /                        the list of stations
+     *   /station/YYYY-MM-DD.svg  the week containing that date
+     *   /station/current.svg     this week
+     *
+     * or .png instead of .svg.
+     */
+    Response Server::get(const http::Request& req)
+    {
+	auto text = [] (const std::string& s) {
+			return std::make_shared<const std::string>(s);
+		    };
+
+	if(req.method!="GET" && req.method!="HEAD") {
+	    return respond(405, "text/plain", text("Method Not Allowed\n"), req);
+	}
+
+	const std::string target = req.target.substr(0, req.target.find('?'));
+	if(target=="/") {
+	    std::string s;
+	    for(const auto& station : stations) s += station.name + '\n';
+	    return respond(200, "text/plain", text(s), req);
+	}
+
+	const size_t slash = target.find('/', 1);
+	const size_t dot = target.rfind('.');
+	if(target[0]=='/' && slash!=std::string::npos &&
+	   dot!=std::string::npos && dot > slash) {
+	    const std::string name = target.substr(1, slash - 1);
+	    const std::string when = target.substr(slash + 1, dot - slash - 1);
+	    const std::string format = target.substr(dot + 1);
+	    for(unsigned n = 0; n < stations.size(); n++) {
+		if(stations[n].name!=name) continue;
+		if(format!="svg" && format!="png") break;
+		return plot(n, when, format, req);
+	    }
+	}
+	return respond(404, "text/plain", text("Not Found\n"), req);
+    }
+
+    /**
+     * Answer with the plot of station n for the week containing
+     * 'when', from the cache if possible.
+     */
+    Response Server::plot(unsigned n, const std::string& when,
+			  const std::string& format,
+			  const http::Request& req)
+    {
+	std::time_t t = std::time(nullptr);
+	if(when!="current" &&
+	   (when.size()!=10 || !timestamp::parse(when, t))) {
+	    return respond(404, "text/plain",
+			   std::make_shared<const std::string>("Not Found\n"),
+			   req);
+	}
+	const Week week {t};
+	const PlotCache::Key key {n, week.monday()};
+
+	PlotCache::Entry* entry = cache.find(key);
+	if(!entry) {
+	    Curves curves {week, {stations[n].path}, 1, std::cerr};
+	    entry = &cache.insert(key, std::move(curves));
+	}
+
+	const bool png = format=="png";
+	PlotCache::Plot plot;
+	auto it = entry->plots.find(format);
+	if(it!=entry->plots.end()) {
+	    plot = it->second;
+	}
+	else {
+	    plot = std::make_shared<const std::string>(render(week, opt,
+							      entry->curves,
+							      png));
+	    cache.add(*entry, format, plot);
+	    if(opt.verbose) {
+		std::cerr << stations[n].name << ": rendered " << key.monday
+			  << '.' << format << "; cache "
+			  << cache.entries() << " weeks, "
+			  << cache.size() << " bytes\n";
+	    }
+	}
+	return respond(200, png ? "image/png" : "image/svg+xml", plot, req);
+    }
+
+    /**
+     * Forget what has changed in the files.
+     */
+    void Server::changed(const std::vector<Watch::Change>& changes)
+    {
+	for(const auto& change : changes) {
+	    const unsigned n = change.file;
+	    if(change.all) {
+		cache.invalidate(n);
+		if(opt.verbose) {
+		    std::cerr << stations[n].name << ": changed\n";
+		}
+		continue;
+	    }
+	    for(const auto& monday : change.weeks) {
+		cache.invalidate(n, monday);
+		if(opt.verbose) {
+		    std::cerr << stations[n].name << ": " << monday << " changed\n";
+		}
+	    }
+	}
+    }
+
+    /**
+     * A client connection: what it has sent which isn't a complete
+     * request yet, and the responses not yet written to it, the first
+     * one 'written' bytes into it.  It's closed when 'closing' and
+     * there is nothing more to write.
+     */
+    struct Connection {
+	std::string in;
+	std::deque<Response> out;
+	size_t written = 0;
+	bool closing = false;
+
+	bool reading() const { return !closing && out.size() < backlog; }
+	static const size_t backlog = 16;
+    };
+
+    /**
+     * Read what the client has sent, and queue the responses to
+     * the complete requests among it.  Returns false if the
+     * connection is broken.
+     *
+     * Neither grows without bound: reading stops as soon as there's
+     * more than a request header's worth of input (which is then
+     * either complete requests, or a bad one), and while the client
+     * isn't reading the responses to its pipelined requests.
+     */
+    bool receive(int fd, Connection& conn, Server& server)
+    {
+	char buf[8192];
+	while(conn.reading() && conn.in.size() <= http::limit) {
+	    const ssize_t n = read(fd, buf, sizeof buf);
+	    if(n==0) conn.closing = true;
+	    if(n==-1) {
+		if(errno==EAGAIN || errno==EWOULDBLOCK) break;
+		if(errno==EINTR) continue;
+		return false;
+	    }
+	    if(n > 0) conn.in.append(buf, n);
+	}
+
+	while(true) {
+	    http::Request req;
+	    size_t n;
+	    const http::Parse parse = http::parse(conn.in, n, req);
+	    if(parse==http::Parse::incomplete) break;
+	    if(parse==http::Parse::bad) {
+		const std::string s = "Bad Request\n";
+		conn.out.push_back({http::header(400, "text/plain", s.size(), false),
+				    std::make_shared<const std::string>(s)});
+		conn.closing = true;
+		break;
+	    }
+	    conn.in.erase(0, n);
+	    conn.out.push_back(server.get(req));
+	    if(!req.keep_alive) {
+		conn.closing = true;
+		break;
+	    }
+	}
+	if(conn.closing) conn.in.clear();
+	return true;
+    }
+
+    /**
+     * Write as much of the queued responses as the client will take.
+     * Returns false if the connection is broken.
+     */
+    bool send(int fd, Connection& conn)
+    {
+	while(conn.out.size()) {
+	    const Response& r = conn.out.front();
+	    const size_t hsize = r.header.size();
+	    const size_t size = hsize + (r.body ? r.body->size() : 0);
+
+	    iovec iov[2];
+	    int iovcnt = 0;
+	    if(conn.written < hsize) {
+		iov[iovcnt++] = {const_cast<char*>(r.header.data()) + conn.written,
+				 hsize - conn.written};
+	    }
+	    if(r.body && r.body->size()) {
+		const size_t skip = conn.written < hsize ? 0 : conn.written - hsize;
+		iov[iovcnt++] = {const_cast<char*>(r.body->data()) + skip,
+				 r.body->size() - skip};
+	    }
+
+	    const ssize_t n = writev(fd, iov, iovcnt);
+	    if(n==-1) {
+		if(errno==EAGAIN || errno==EWOULDBLOCK) return true;
+		if(errno==EINTR) continue;
+		return false;
+	    }
+	    conn.written += n;
+	    if(conn.written==size) {
+		conn.out.pop_front();
+		conn.written = 0;
+	    }
+	}
+	return true;
+    }
+
+    /**
+     * A non-blocking socket listening on address:port, or -1.
+     */
+    int listen_on(const std::string& address, unsigned port)
+    {
+	sockaddr_in sa {};
+	sa.sin_family = AF_INET;
+	sa.sin_port = htons(port);
+	if(inet_pton(AF_INET, address.c_str(), &sa.sin_addr)!=1) {
+	    std::cerr << "error: bad address '" << address << "'\n";
+	    return -1;
+	}
+
+	const int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	const int one = 1;
+	if(fd==-1 ||
+	   setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one) ||
+	   bind(fd, reinterpret_cast<sockaddr*>(&sa), sizeof sa) ||
+	   listen(fd, 64)) {
+	    std::cerr << "cannot listen on " << address << ':' << port << ": "
+		      << std::strerror(errno) << '\n';
+	    if(fd!=-1) close(fd);
+	    return -1;
+	}
+	return fd;
+    }
+
+    bool watch(int ep, int fd, uint32_t events, int op = EPOLL_CTL_ADD)
+    {
+	epoll_event ev {};
+	ev.events = events;
+	ev.data.fd = fd;
+	return !epoll_ctl(ep, op, fd, &ev);
+    }
+
+    /**
+     * Serve clients connecting to 'listener', and keep track of the
+     * changes to the files, until something fails.
+     */
+    int serve(int listener, Watch& files, Server& server)
+    {
+	const int ep = epoll_create1(EPOLL_CLOEXEC);
+	if(ep==-1 ||
+	   !watch(ep, listener, EPOLLIN) ||
+	   !watch(ep, files.fd(), EPOLLIN)) {
+	    std::cerr << "epoll: " << std::strerror(errno) << '\n';
+	    return 1;
+	}
+
+	std::map<int, Connection> conns;
+	epoll_event events[64];
+	while(true) {
+	    const int n = epoll_wait(ep, events, 64, -1);
+	    if(n==-1) {
+		if(errno==EINTR) continue;
+		std::cerr << "epoll: " << std::strerror(errno) << '\n';
+		return 1;
+	    }
+
+	    for(int i = 0; i < n; i++) {
+		const int fd = events[i].data.fd;
+		if(fd==listener) {
+		    int c;
+		    while((c = accept4(listener, nullptr, nullptr,
+				       SOCK_NONBLOCK | SOCK_CLOEXEC)) != -1) {
+			if(watch(ep, c, EPOLLIN)) conns[c];
+			else close(c);
+		    }
+		    continue;
+		}
+		if(fd==files.fd()) {
+		    server.changed(files.read());
+		    continue;
+		}
+
+		Connection& conn = conns[fd];
+		bool ok = receive(fd, conn, server) && send(fd, conn);
+		if(ok && conn.closing && conn.out.empty()) ok = false;
+		if(ok) {
+		    uint32_t ev = 0;
+		    if(conn.reading()) ev |= EPOLLIN;
+		    if(conn.out.size()) ev |= EPOLLOUT;
+		    ok = watch(ep, fd, ev, EPOLL_CTL_MOD);
+		}
+		if(!ok) {
+		    close(fd);
+		    conns.erase(fd);
+		}
+	    }
+	}
+    }
+}
+
+
+int main(int argc, char ** argv)
+{
+    const std::string prog = argv[0];
+    const std::string usage = std::string("usage: ")
+	+ prog + " [-w] [-d] [-s tolerance] [-m megabytes] [-a address] [-p port] [-v] file ...\n"
+	"       "
+	+ prog + " --help\n"
+	"       "
+	+ prog + " --version";
+    const char optstring[] = "wds:m:a:p:v";
+    const struct option long_options[] = {
+	{"help", 0, 0, 'H'},
+	{"version", 0, 0, 'V'},
+	{0, 0, 0, 0}
+    };
+
+    std::cin.sync_with_stdio(false);
+    std::cout.sync_with_stdio(false);
+
+    Options opt;
+    size_t megabytes = 64;
+    std::string address = "127.0.0.1";
+    unsigned long port = 8080;
+
+    int ch;
+    while((ch = getopt_long(argc, argv,
+			    optstring,
+			    &long_options[0], 0)) != -1) {
+	char* end;
+	switch(ch) {
+	case 'w':
+	    opt.use_wind_direction = true;
+	    break;
+	case 'd':
+	    opt.thin.decimate = true;
+	    break;
+	case 's':
+	    opt.thin.tolerance = std::strtod(optarg, &end);
+	    if(end==optarg || *end || !(opt.thin.tolerance >= 0)) {
+		std::cerr << "error: incorrect -s argument\n"
+			  << usage << '\n';
+		return 1;
+	    }
+	    break;
+	case 'm':
+	    megabytes = std::strtoul(optarg, &end, 10);
+	    if(end==optarg || *end) {
+		std::cerr << "error: incorrect -m argument\n"
+			  << usage << '\n';
+		return 1;
+	    }
+	    break;
+	case 'a':
+	    address = optarg;
+	    break;
+	case 'p':
+	    port = std::strtoul(optarg, &end, 10);
+	    if(end==optarg || *end || !port || port > 65535) {
+		std::cerr << "error: incorrect -p argument\n"
+			  << usage << '\n';
+		return 1;
+	    }
+	    break;
+	case 'v':
+	    opt.verbose = true;
+	    break;
+	case 'H':
+	    std::cout << usage << '\n';
+	    return 0;
+	    break;
+	case 'V':
+	    std::cout << "weather_serve, part of Weather 4.1\n"
+		      << "Copyright (c) 2026 Jrgen Grahn\n";
+	    return 0;
+	    break;
+	case ':':
+	case '?':
+	default:
+	    std::cerr << usage << '\n';
+	    return 1;
+	    break;
+	}
+    }
+
+    const std::vector<std::string> files {argv+optind, argv+argc};
+    if(files.empty()) {
+	std::cerr << "error: no station files\n"
+		  << usage << '\n';
+	return 1;
+    }
+
+    std::vector<Station> stations;
+    std::set<std::string> names;
+    for(const auto& path : files) {
+	const Station station {station_name(path), path};
+	if(!names.insert(station.name).second) {
+	    std::cerr << "error: more than one station named '"
+		      << station.name << "'\n";
+	    return 1;
+	}
+	stations.push_back(station);
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+
+    const int listener = listen_on(address, port);
+    if(listener==-1) return 1;
+
+    Watch watch {files};
+    if(watch.error()) {
+	std::cerr << "cannot watch the station files: "
+		  << std::strerror(watch.error()) << '\n';
+	return 1;
+    }
+
+    Server server {stations, opt, megabytes << 20};
+    if(opt.verbose) {
+	std::cerr << "listening on " << address << ':' << port << '\n';
+    }
+    return serve(listener, watch, server);
+}
@@ -27,17 +27,28 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <iomanip>
 #include <vector>
 #include <cstring>
 #include <cstdlib>
 #include <ctime>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <algorithm>
 
 #include <getopt.h>
 
 #include "plot.h"
 #include "area.h"
 #include "week.h"
+#include "curves.h"
+#include "cache.h"
 #include "files...h"
+#include "gzip.h"
+#include "raster.h"
 
 
 namespace {
@@ -56,29 +67,255 @@ namespace {
      * code.
      */
     int plot_week(const Week& when, bool use_wind_direction,
-		  Files& files,
+		  const WeekPlot::Thinning& thin,
+		  const Curves& curves,
 		  std::ostream& os)
     {
 	const Area temperature{{-20, +30}, {700, 200}};
 	const SubArea rain{temperature, {0, 20}, 200 * 3/5};
 	const Area wind{temperature, {0, 20}, 50};
 	WeekPlot plot{os, when, temperature, rain, wind};
-	plot.plot(when, use_wind_direction, files);
+	plot.decimate(thin.decimate);
+	plot.simplify(thin.tolerance);
+	plot.plot(use_wind_direction, curves);
 	return 0;
     }
 
+    /**
+     * How the image is written: as PNG, or as SVG gzip-compressed at
+     * 'level' 1--9, or not at all if it's 0; and whether to print
+     * statistics.
+     */
+    struct Output {
+	bool png = false;
+	int level = 0;
+	bool verbose = false;
+    };
+
+    bool ends_with(const std::string& name, const std::string& ext)
+    {
+	return name.size() > ext.size() &&
+	    name.compare(name.size() - ext.size(), ext.size(), ext)==0;
+    }
+
+    /**
+     * Like plot_week(..., os), but rasterized to PNG if out.png is
+     * set, or compressing as we go if out.level is.  'name' is for
+     * messages, which go to 'err'.
+     */
+    int plot_week(const Week& when, bool use_wind_direction,
+		  const WeekPlot::Thinning& thin,
+		  const Curves& curves,
+		  std::ostream& os, const std::string& name,
+		  const Output& out, std::ostream& err)
+    {
+	if(out.png) {
+	    std::ostringstream svg;
+	    const int rc = plot_week(when, use_wind_direction, thin,
+				     curves, svg);
+	    const raster::Canvas canvas = raster::rasterize(svg.str());
+	    if(!canvas.png(os)) {
+		err << "cannot write '" << name << "': "
+		    << std::strerror(errno) << '\n';
+		return 1;
+	    }
+	    return rc;
+	}
+
+	if(!out.level) return plot_week(when, use_wind_direction, thin,
+					curves, os);
+
+	Gzip gz {os, out.level};
+	std::ostream zos {&gz};
+	const int rc = plot_week(when, use_wind_direction, thin,
+				 curves, zos);
+	if(!gz.finish()) {
+	    err << "cannot write '" << name << "': "
+		<< std::strerror(errno) << '\n';
+	    return 1;
+	}
+	if(out.verbose) {
+	    err << name << ": " << gz.in() << " bytes, "
+		<< gz.out() << " compressed\n";
+	}
+	return rc;
+    }
+
+    /**
+     * Plot to the file 'image_name'.  Names ending in .png are
+     * rasterized, and names ending in .svgz compressed even if 'out'
+     * doesn't say so, at gzip's default level.
+     */
     int plot_week(const Week& when, bool use_wind_direction,
-		  Files& files,
-		  const std::string& image_name)
+		  const WeekPlot::Thinning& thin,
+		  const Curves& curves,
+		  const std::string& image_name,
+		  Output out, std::ostream& err)
     {
 	std::ofstream os(image_name);
 	if(!os) {
-	    std::cerr << "cannot open '" << image_name << "' for writing: "
-		      << std::strerror(errno) << '\n';
+	    err << "cannot open '" << image_name << "' for writing: "
+		<< std::strerror(errno) << '\n';
 	    return 1;
 	}
-	return plot_week(when, use_wind_direction,
-			 files, os);
+	if(ends_with(image_name, ".png")) out.png = true;
+	if(!out.level && ends_with(image_name, ".svgz")) out.level = 6;
+	return plot_week(when, use_wind_direction, thin,
+			 curves, os, image_name, out, err);
+    }
+
+    /**
+     * Call f(0), f(1) ... f(n-1) from up to 'jobs' threads.  Each
+     * thread takes the next index no one has claimed yet, so a thread
+     * which finishes early keeps taking work until there is none.
+     */
+    template <class F>
+    void run(unsigned n, unsigned jobs, F f)
+    {
+	std::atomic<unsigned> next{0};
+	auto work = [&] {
+			unsigned i;
+			while((i = next++) < n) f(i);
+		    };
+
+	std::vector<std::thread> pool;
+	while(pool.size() < std::max(jobs, 1u) && pool.size() < n) pool.emplace_back(work);
+	for(auto& thread : pool) thread.join();
+    }
+
+    /**
+     * Plot the 'n' weeks up to and including 'when' into files named
+     * by 'pattern', as by Week::format().  The input is read once,
+     * and the plots rendered by 'jobs' threads.
+     */
+    int plot_weeks(Week when, unsigned n, bool use_wind_direction,
+		   const WeekPlot::Thinning& thin,
+		   const std::vector<std::string>& files,
+		   const std::string& pattern,
+		   const Output& out,
+		   unsigned jobs)
+    {
+	std::vector<Week> weeks;
+	while(weeks.size() < n) {
+	    weeks.push_back(when);
+	    when = when.prev();
+	}
+	std::reverse(begin(weeks), end(weeks));
+
+	Files ff {files.begin(), files.end()};
+	const auto curves = Curves::weeks(weeks, ff, std::cerr);
+
+	std::vector<int> rc(n);
+	std::vector<std::string> err(n);
+	run(n, jobs, [&] (unsigned i) {
+			 std::ostringstream oss;
+			 rc[i] = plot_week(weeks[i], use_wind_direction,
+					   thin, curves[i],
+					   weeks[i].format(pattern.c_str()),
+					   out, oss);
+			 err[i] = oss.str();
+		     });
+
+	for(const auto& s : err) std::cerr << s;
+	return *std::max_element(begin(rc), end(rc));
+    }
+
+    /**
+     * A plot in a batch manifest: an output file and its input files.
+     */
+    struct Job {
+	std::string out;
+	std::vector<std::string> in;
+    };
+
+    /**
+     * Read a batch manifest: one plot per line, the output file
+     * followed by the input files, separated by whitespace.  Empty
+     * lines and #-comments are ignored.  Returns false, after
+     * complaining, if the manifest cannot be read or is malformed.
+     */
+    bool read_manifest(const std::string& path, std::vector<Job>& jobs)
+    {
+	std::ifstream is {path};
+	if(!is) {
+	    std::cerr << "cannot open '" << path << "': "
+		      << std::strerror(errno) << '\n';
+	    return false;
+	}
+
+	std::string s;
+	unsigned n = 0;
+	while(std::getline(is, s)) {
+	    n++;
+	    std::istringstream iss {s};
+	    Job job;
+	    if(!(iss >> job.out) || job.out[0]=='#') continue;
+	    std::string in;
+	    while(iss >> in) job.in.push_back(in);
+	    if(job.in.empty()) {
+		std::cerr << path << ':' << n << ": no input files for '"
+			  << job.out << "'\n";
+		return false;
+	    }
+	    jobs.push_back(job);
+	}
+	if(is.bad()) {
+	    std::cerr << "cannot read '" << path << "': "
+		      << std::strerror(errno) << '\n';
+	    return false;
+	}
+	return true;
+    }
+
+    /**
+     * Plot the week for all plots in the manifest, from 'jobs'
+     * threads.  Each plot reads its own input files in its own thread.
+     * Errors (and, if 'verbose', the time taken for each plot and in
+     * total) are printed in manifest order when all are done.
+     */
+    int plot_batch(const Week& when, bool use_wind_direction,
+		   const WeekPlot::Thinning& thin,
+		   const std::string& manifest,
+		   const Output& out,
+		   unsigned jobs)
+    {
+	const bool verbose = out.verbose;
+	using Clock = std::chrono::steady_clock;
+	using ms = std::chrono::duration<double, std::milli>;
+	const auto t0 = Clock::now();
+
+	std::vector<Job> batch;
+	if(!read_manifest(manifest, batch)) return 1;
+
+	const unsigned n = batch.size();
+	std::vector<int> rc(n);
+	std::vector<std::string> err(n);
+	std::vector<double> took(n);
+	run(n, jobs, [&] (unsigned i) {
+			 const auto t0 = Clock::now();
+			 const Job& job = batch[i];
+			 std::ostringstream oss;
+			 const Curves curves {when, job.in, 1, oss};
+			 rc[i] = plot_week(when, use_wind_direction, thin,
+					   curves, job.out, out, oss);
+			 err[i] = oss.str();
+			 took[i] = ms(Clock::now() - t0).count();
+		     });
+
+	for(unsigned i = 0; i < n; i++) {
+	    std::cerr << err[i];
+	    if(verbose) {
+		std::cerr << batch[i].out << ": "
+			  << std::fixed << std::setprecision(1)
+			  << took[i] << " ms\n";
+	    }
+	}
+	if(verbose) {
+	    std::cerr << "batch: " << n << " plots in "
+		      << std::fixed << std::setprecision(1)
+		      << ms(Clock::now() - t0).count() << " ms\n";
+	}
+	return n ? *std::max_element(begin(rc), end(rc)) : 0;
     }
 }
 
@@ -87,13 +324,21 @@ int main(int argc, char ** argv)
 {
     const std::string prog = argv[0];
     const std::string usage = std::string("usage: ")
-	+ prog + " [-p N] [-w] [-o image-file] file ...\n"
+	+ prog + " [-p N] [-w] [-d] [-s tolerance] [-j jobs] [-c dir] [-v] [-z level] [-o image-file] file ...\n"
+	"       "
+	+ prog + " [-p N] [-w] [-d] [-s tolerance] [-j jobs] [-z level] [--weeks N] --out-pattern pattern file ...\n"
+	"       "
+	+ prog + " [-p N] [-w] [-d] [-s tolerance] [-j jobs] [-v] [-z level] --batch manifest\n"
 	"       "
 	+ prog + " --help\n"
 	"       "
 	+ prog + " --version";
-    const char optstring[] = "p:wo:";
+    const char optstring[] = "p:wds:j:c:vz:o:";
     const struct option long_options[] = {
+	{"weeks", 1, 0, 'W'},
+	{"out-pattern", 1, 0, 'P'},
+	{"batch", 1, 0, 'B'},
+	{"compress", 1, 0, 'z'},
 	{"help", 0, 0, 'H'},
 	{"version", 0, 0, 'V'},
 	{0, 0, 0, 0}
@@ -105,6 +350,13 @@ int main(int argc, char ** argv)
     std::string image_name;
     Week when {now()};
     bool use_wind_direction = false;
+    WeekPlot::Thinning thin;
+    unsigned jobs = std::thread::hardware_concurrency();
+    std::string cache_dir;
+    Output out;
+    unsigned weeks = 1;
+    std::string pattern;
+    std::string manifest;
 
     int ch;
     while((ch = getopt_long(argc, argv,
@@ -123,9 +375,56 @@ int main(int argc, char ** argv)
 	case 'w':
 	    use_wind_direction = true;
 	    break;
+	case 'd':
+	    thin.decimate = true;
+	    break;
+	case 's':
+	    thin.tolerance = std::strtod(optarg, &end);
+	    if(end==optarg || *end || !(thin.tolerance >= 0)) {
+		std::cerr << "error: incorrect -s argument\n"
+			  << usage << '\n';
+		return 1;
+	    }
+	    break;
+	case 'j':
+	    jobs = std::strtoul(optarg, &end, 10);
+	    if(end==optarg || *end) {
+		std::cerr << "error: incorrect -j argument\n"
+			  << usage << '\n';
+		return 1;
+	    }
+	    break;
+	case 'c':
+	    cache_dir = optarg;
+	    break;
+	case 'v':
+	    out.verbose = true;
+	    break;
+	case 'z':
+	    out.level = std::strtol(optarg, &end, 10);
+	    if(end==optarg || *end || out.level < 1 || out.level > 9) {
+		std::cerr << "error: incorrect -z argument\n"
+			  << usage << '\n';
+		return 1;
+	    }
+	    break;
 	case 'o':
 	    image_name = optarg;
 	    break;
+	case 'W':
+	    weeks = std::strtoul(optarg, &end, 10);
+	    if(end==optarg || *end || !weeks) {
+		std::cerr << "error: incorrect --weeks argument\n"
+			  << usage << '\n';
+		return 1;
+	    }
+	    break;
+	case 'P':
+	    pattern = optarg;
+	    break;
+	case 'B':
+	    manifest = optarg;
+	    break;
 	case 'H':
 	    std::cout << usage << '\n';
 	    return 0;
@@ -144,13 +443,47 @@ int main(int argc, char ** argv)
 	}
     }
 
-    Files files {argv+optind, argv+argc};
+    const std::vector<std::string> files {argv+optind, argv+argc};
+
+    if(manifest.size()) {
+	if(files.size() || image_name.size() || pattern.size() || weeks > 1) {
+	    std::cerr << "error: --batch takes its files from the manifest\n"
+		      << usage << '\n';
+	    return 1;
+	}
+	return plot_batch(when, use_wind_direction, thin,
+			  manifest, out, jobs);
+    }
+
+    if(weeks > 1 || pattern.size()) {
+	if(pattern.empty() || image_name.size()) {
+	    std::cerr << "error: --weeks needs --out-pattern rather than -o\n"
+		      << usage << '\n';
+	    return 1;
+	}
+	return plot_weeks(when, weeks, use_wind_direction, thin,
+			  files, pattern, out, jobs);
+    }
+    Curves curves;
+    if(cache_dir.size()) {
+	CurveCache cache {cache_dir};
+	curves = Curves{when, files, jobs, cache, std::cerr};
+	if(out.verbose) {
+	    std::cerr << "cache: "
+		      << cache.stats.hits << " hits, "
+		      << cache.stats.partial << " partial, "
+		      << cache.stats.misses << " misses\n";
+	}
+    }
+    else {
+	curves = Curves{when, files, jobs, std::cerr};
+    }
 
     if (image_name.size()) {
-	return plot_week(when, use_wind_direction,
-			 files, image_name);
+	return plot_week(when, use_wind_direction, thin,
+			 curves, image_name, out, std::cerr);
     }
 
-    return plot_week(when, use_wind_direction,
-		     files, std::cout);
+    return plot_week(when, use_wind_direction, thin,
+		     curves, std::cout, "standard output", out, std::cerr);
 }
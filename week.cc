@@ -26,23 +26,35 @@
  */
 #include "week.h"
 
+#include "timestamp.h"
+
 #include <iostream>
 #include <cstdio>
+#include <ctime>
 #include <time.h>
 
 using std::time_t;
 
 namespace {
     /**
-     * Parse a time in ISO 2018-10-06T22:20:00 format,
-     * local time implied.
+     * localtime(3), but safe to use from several threads.
+     */
+    std::tm local(time_t t)
+    {
+	std::tm tm;
+	localtime_r(&t, &tm);
+	return tm;
+    }
+
+    /**
+     * Parse a time in ISO 2018-10-06T22:20:00 format, with local time
+     * implied unless there's an offset.  Garbage becomes the epoch.
      */
     time_t parse(const std::string& ts)
     {
-	std::tm tm = {};
-	tm.tm_isdst = -1;
-	strptime(ts.c_str(), "%FT%H:%M:%S", &tm);
-	return mktime(&tm);
+	time_t t = 0;
+	timestamp::parse(ts, t);
+	return t;
     }
 
     /**
@@ -53,10 +65,10 @@ namespace {
     {
 	// small steps: some days are shorter than 24 h, but not 20 h
 	const unsigned step = 20 * 60 * 60;
-	std::tm tm = *localtime(&t);
+	std::tm tm = local(t);
 	while(tm.tm_wday != 1) {
 	    t -= step;
-	    tm = *localtime(&t);
+	    tm = local(t);
 	}
 	tm.tm_sec = tm.tm_min = tm.tm_hour = 0;
 	return mktime(&tm);
@@ -69,14 +81,14 @@ namespace {
     time_t find_sunday(time_t t)
     {
 	const unsigned step = 20 * 60 * 60;
-	std::tm tm = *localtime(&t);
+	std::tm tm = local(t);
 	while(tm.tm_wday == 1) {
 	    t += step;
-	    tm = *localtime(&t);
+	    tm = local(t);
 	}
 	while(tm.tm_wday != 1) {
 	    t += step;
-	    tm = *localtime(&t);
+	    tm = local(t);
 	}
 	tm.tm_sec = tm.tm_min = tm.tm_hour = 0;
 	return mktime(&tm);
@@ -87,7 +99,7 @@ namespace {
      */
     std::string date(time_t t)
     {
-	const std::tm tm = *localtime(&t);
+	const std::tm tm = local(t);
 	char buf[11];
 	std::sprintf(buf, "%04d-%02d-%02d",
 		     tm.tm_year + 1900,
@@ -121,7 +133,26 @@ Week::Week(const std::string& ts)
  */
 double Week::scale(const std::string& ts) const
 {
-    const std::time_t dt = parse(ts) - begin;
+    return scale(ts.data(), ts.data() + ts.size());
+}
+
+/**
+ * Like scale(ts), for a timestamp [a, b).  Unparsable timestamps
+ * map to -1, outside the week.
+ */
+double Week::scale(const char* a, const char* b) const
+{
+    time_t t;
+    if(!timestamp::parse(a, b, t)) return -1;
+    return scale(t);
+}
+
+/**
+ * Like scale(ts), for an already parsed time.
+ */
+double Week::scale(time_t t) const
+{
+    const std::time_t dt = t - begin;
     return double(dt)/(end - begin);
 }
 
@@ -140,6 +171,18 @@ std::string Week::sunday() const
     return date(end - 1);
 }
 
+/**
+ * The week's Monday formatted as by strftime(3), e.g. "%G-W%V" for
+ * the ISO week "2018-W47".
+ */
+std::string Week::format(const char* fmt) const
+{
+    const std::tm mon = local(begin);
+    char buf[200];
+    const size_t n = std::strftime(buf, sizeof buf, fmt, &mon);
+    return {buf, n};
+}
+
 /**
  * Pretty-print the week for readability in my preferred
  * format (a traditional format in Sweden):
@@ -151,9 +194,9 @@ std::string Week::sunday() const
 std::ostream& Week::put(std::ostream& os) const
 {
     const char dash[] = "\xe2\x80\x93";
-    const std::tm mon = *localtime(&begin);
+    const std::tm mon = local(begin);
     const auto pend = end - 1;
-    const std::tm sun = *localtime(&pend);
+    const std::tm sun = local(pend);
 
     if(mon.tm_mon == sun.tm_mon) {
 	os << mon.tm_mday << dash
@@ -52,11 +52,15 @@ public:
 	return !(*this == other);
     }
 
+    double scale(std::time_t t) const;
     double scale(const std::string& ts) const;
+    double scale(const char* a, const char* b) const;
+    bool contains(std::time_t t) const { return begin <= t && t <= end; }
 
     Week prev() const;
     std::string monday() const;
     std::string sunday() const;
+    std::string format(const char* fmt) const;
     std::ostream& put(std::ostream& os) const;
 
 private:
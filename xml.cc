@@ -7,48 +7,87 @@
 #include <iostream>
 #include <array>
 #include <algorithm>
+#include <cstring>
+#include <cstdio>
 
 using xml::ostream;
 
 namespace {
 
     template <class A>
-    void escape(std::ostream& os, const A& special,
+    void escape(std::string& os, const A& special,
 		const char* a, const char* b)
     {
 	while (a!=b) {
 	    auto c = std::find_first_of(a, b,
 					begin(special),
 					end(special));
-	    os.write(a, c-a);
+	    os.append(a, c-a);
 	    a = c;
 	    if (a!=b) {
 		switch(*a++) {
-		case '&': os << "&amp;"; break;
-		case '<': os << "&lt;"; break;
-		case '>': os << "&gt;"; break;
-		case '"': os << "&quot;"; break;
-		case '\'': os << "&apos;"; break;
+		case '&': os += "&amp;"; break;
+		case '<': os += "&lt;"; break;
+		case '>': os += "&gt;"; break;
+		case '"': os += "&quot;"; break;
+		case '\'': os += "&apos;"; break;
 		}
 	    }
 	}
     }
 
-    void escape(std::ostream& os, const char* a, const char* b)
+    void escape(std::string& os, const char* a, const char* b)
     {
 	constexpr std::array<char, 3> special {'&', '<', '>'};
 	escape(os, special, a, b);
     }
 
-    std::ostream& escape(std::ostream& os, const xml::attr& attr)
+    std::string& escape(std::string& os, const xml::attr& attr)
     {
 	constexpr std::array<char, 5> special {'&', '<', '>', '"', '\''};
-
-	auto a = attr.val.data();
-	auto b = a + attr.val.size();
-	escape(os, special, a, b);
+	escape(os, special, attr.begin(), attr.end());
 	return os;
     }
+
+    /* Write the buffer to the std::ostream once it's this large.
+     */
+    constexpr size_t block = 1 << 16;
+}
+
+
+xml::attr::attr(const char* name, const char* val)
+    : name(name),
+      val(val),
+      size(std::strlen(val))
+{}
+
+xml::attr::attr(const char* name, const std::string& val)
+    : name(name),
+      val(val.data()),
+      size(val.size())
+{}
+
+xml::attr::attr(const char* name, int val)
+    : name(name),
+      val(nullptr),
+      size(std::snprintf(buf, sizeof buf, "%d", val))
+{}
+
+xml::attr::attr(const char* name, unsigned val)
+    : name(name),
+      val(nullptr),
+      size(std::snprintf(buf, sizeof buf, "%u", val))
+{}
+
+/**
+ * A number with a fixed number of decimals, as by printf "%.*f".
+ */
+xml::attr::attr(const char* name, double val, int decimals)
+    : name(name),
+      val(nullptr),
+      size(std::snprintf(buf, sizeof buf, "%.*f", decimals, val))
+{
+    if(size >= sizeof buf) size = sizeof buf - 1;
 }
 
 
@@ -61,11 +100,19 @@ ostream::ostream(std::ostream& os, unsigned indent)
 ostream::ostream(std::ostream& os,
 		 const std::string& declaration,
 		 unsigned indent)
-    : os(os),
+    : ss(&pending),
+      os(os),
       indent(indent),
       prev('?')
 {
-    os << declaration;
+    stack.reserve(32);
+    buf.reserve(2 * block);
+    buf += declaration;
+}
+
+ostream::~ostream()
+{
+    flush();
 }
 
 /**
@@ -76,7 +123,7 @@ ostream& ostream::operator<< (const xml::elem& e)
     switch(prev) {
     case 'e':
     case 'a':
-	os << '>';
+	buf += '>';
 	nl_indent();
 	break;
     case 't':
@@ -87,8 +134,9 @@ ostream& ostream::operator<< (const xml::elem& e)
 	nl_indent();
 	break;
     }
-    os << '<' << e.val;
-    stack.push(e);
+    buf += '<';
+    buf += e.val;
+    stack.push_back(e.val);
     prev = 'e';
     return *this;
 }
@@ -98,25 +146,35 @@ ostream& ostream::operator<< (const xml::elem& e)
  */
 ostream& ostream::operator<< (const xml::elem_end&)
 {
-    const elem e = stack.top();
-    stack.pop();
+    const char* const e = stack.back();
+    stack.pop_back();
 
     switch(prev) {
     case 'e':
     case 'a':
-	os << "/>";
+	buf += "/>";
 	break;
     case 't':
 	flush_indent();
-	os << "</" << e.val << '>';
+	buf += "</";
+	buf += e;
+	buf += '>';
 	break;
     case '.':
 	nl_indent();
-	os << "</" << e.val << '>';
+	buf += "</";
+	buf += e;
+	buf += '>';
 	break;
     }
-    if(stack.empty()) os << '\n';
     prev = '.';
+    if(stack.empty()) {
+	buf += '\n';
+	flush();
+    }
+    else {
+	spill();
+    }
     return *this;
 }
 
@@ -130,24 +188,87 @@ ostream& ostream::operator<< (const xml::attr& attr)
     case 'e':
     case 'a':
 	nl_indent();
-	os << attr.name << "='";
-	escape(os, attr) << "'";
+	buf += attr.name;
+	buf += "='";
+	escape(buf, attr) += '\'';
 	break;
     }
     prev = 'a';
     return *this;
 }
 
+ostream& ostream::operator<< (const char* s)
+{
+    pending.s += s;
+    if(prev=='t') return *this;
+    return text();
+}
+
+ostream& ostream::operator<< (const std::string& s)
+{
+    pending.s += s;
+    if(prev=='t') return *this;
+    return text();
+}
+
+/**
+ * Splice in a fragment recorded earlier.  Undefined results if
+ * this isn't the same place in the document as where it was recorded.
+ */
+ostream& ostream::operator<< (const fragment& f)
+{
+    buf += f.s;
+    prev = f.after;
+    spill();
+    return *this;
+}
+
+/**
+ * Start recording into 'f' what's fed to the stream.  Text must not
+ * be pending, i.e. recording starts right after an element or an
+ * attribute.
+ */
+void ostream::record(fragment& f)
+{
+    recording = buf.size();
+    f.s.clear();
+}
+
 /**
- * Add a piece of text.  (The actual text, meanwhile, goes to a
- * std::ostringstream, from whence it's flushed later.)
+ * Stop recording into 'f'.  The elements opened since record() must
+ * have been closed.
+ */
+void ostream::stop(fragment& f)
+{
+    f.s.assign(buf, recording, std::string::npos);
+    f.after = prev;
+    recording = std::string::npos;
+}
+
+/**
+ * Write what's buffered to the std::ostream.
+ */
+void ostream::flush()
+{
+    os.write(buf.data(), buf.size());
+    buf.clear();
+}
+
+void ostream::spill()
+{
+    if(buf.size() >= block && recording==std::string::npos) flush();
+}
+
+/**
+ * Add a piece of text.  (The actual text, meanwhile, is collected
+ * in 'pending', from whence it's flushed later.)
  */
 ostream& ostream::text()
 {
     switch(prev) {
     case 'e':
     case 'a':
-	os << '>';
+	buf += '>';
 	nl_indent();
 	break;
     case 't':
@@ -160,30 +281,31 @@ ostream& ostream::text()
     return *this;
 }
 
-void ostream::nl_indent() const
+void ostream::nl_indent()
 {
-    static const std::string s = "\n                    ";
-    const unsigned nsp = s.size() - 1;
-    unsigned n = stack.size() * indent;
-    os.write(s.data(), 1 + std::min(nsp, n));
-    n -= std::min(nsp, n);
-
-    while(n) {
-	os.write(s.data() + 1, std::min(nsp, n));
-	n -= std::min(nsp, n);
-    }
+    buf += '\n';
+    buf.append(stack.size() * indent, ' ');
 }
 
 void ostream::flush_indent()
 {
-    std::string s = ss.str();
-    ss.str("");
-
-    if(s.empty() || s.back() != '\n') s += '\n';
-
+    std::string& s = pending.s;
     auto a = s.data();
     auto b = a + s.size();
     if(a!=b && b[-1]=='\n') b--;
-    escape(os, a, b);
+    escape(buf, a, b);
+    s.clear();
     nl_indent();
 }
+
+ostream::Text::int_type ostream::Text::overflow(int_type c)
+{
+    if(c != traits_type::eof()) s += traits_type::to_char_type(c);
+    return traits_type::not_eof(c);
+}
+
+std::streamsize ostream::Text::xsputn(const char* p, std::streamsize n)
+{
+    s.append(p, n);
+    return n;
+}
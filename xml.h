@@ -8,34 +8,74 @@
 #define XML_STREAM_H
 
 #include <iosfwd>
+#include <ostream>
+#include <streambuf>
 #include <string>
-#include <sstream>
-#include <stack>
+#include <vector>
+#include <cstddef>
 
 namespace xml {
 
     /**
      * An element tag, e.g. the foo in <foo>. Used to open an element.
+     *
+     * Only the pointer is kept until the element is closed, so the
+     * name must outlive the element.  Hence it can only be made from
+     * an array, in practice a string literal; not from a pointer
+     * like std::string::c_str().
      */
     struct elem {
-	template <class T>
-	explicit elem(const T& val) : val(val) {}
-	std::string val;
+	template <size_t N>
+	explicit elem(const char (&val)[N]) : val(val) {}
+	const char* val;
     };
 
     /**
      * A key='value' attribute. You don't have to (should not) quote
      * the value.
+     *
+     * The name and a string value are referred to rather than copied,
+     * so feed the attr to the xml::ostream in the expression which
+     * creates it.  Numbers are formatted into the attr itself.
      */
-    struct attr {
-	template <class Name, class Val>
-	attr(const Name& name, const Val& val)
-	    : name(name), val(val)
-	{}
-	std::string name;
-	std::string val;
+    class attr {
+    public:
+	attr(const char* name, const char* val);
+	attr(const char* name, const std::string& val);
+	attr(const char* name, int val);
+	attr(const char* name, unsigned val);
+	attr(const char* name, double val, int decimals);
+
+	template <class Format>
+	static attr formatted(const char* name, Format format);
+
+	const char* const name;
+	const char* begin() const { return val ? val : buf; }
+	const char* end() const { return begin() + size; }
+	static constexpr size_t capacity = 64;
+
+    private:
+	explicit attr(const char* name) : name(name), val(nullptr), size(0) {}
+
+	const char* val;
+	size_t size;
+	char buf[capacity];
     };
 
+    /**
+     * A value formatted straight into the attr by format(buf, size),
+     * which returns the length like fixed1() does.  There's room for
+     * attr::capacity - 1 octets; a value which may be longer than
+     * that should be given as a string instead.
+     */
+    template <class Format>
+    attr attr::formatted(const char* name, Format format)
+    {
+	attr a{name};
+	a.size = format(a.buf, sizeof a.buf);
+	return a;
+    }
+
     /**
      * The closing of an element.  All elements opened must eventually
      * be closed, if you want to create valid XML.
@@ -43,6 +83,20 @@ namespace xml {
     struct elem_end {};
     constexpr elem_end end;
 
+    /**
+     * A piece of a document, recorded from an xml::ostream by
+     * record() and stop(), which can be fed to another xml::ostream
+     * in a single write.  It's only valid to do that where the
+     * recording began: at the same element depth, and after the same
+     * kind of thing (an element, an attribute or a closed element).
+     */
+    class fragment {
+    private:
+	friend class ostream;
+	std::string s;
+	char after = 0;
+    };
+
     /**
      * Stream-like object for generating XML and feeding it into a
      * std::ostream.  Only handles the boring parts:
@@ -67,28 +121,60 @@ namespace xml {
      * transcoding going on, and the resulting XML is by default
      * marked as utf-8.  It's up to the user to keep the document
      * well-formed in this respect.
+     *
+     * The document is built in a buffer, which is written to the
+     * std::ostream in large blocks, when the document ends, and on
+     * flush().  Once the buffers have grown to size, writing doesn't
+     * allocate memory.
      */
     class ostream {
     public:
 	ostream(std::ostream& os, unsigned indent = 2);
 	ostream(std::ostream& os, const std::string& declaration,
 		unsigned indent = 2);
+	~ostream();
+	ostream(const ostream&) = delete;
+	ostream& operator= (const ostream&) = delete;
 
 	ostream& operator<< (const elem& e);
 	ostream& operator<< (const elem_end& e);
 	ostream& operator<< (const attr& attr);
+	ostream& operator<< (const char* s);
+	ostream& operator<< (const std::string& s);
+	ostream& operator<< (const fragment& f);
 
 	template <class T>
 	ostream& operator<< (const T& val);
 
+	void flush();
+
+	void record(fragment& f);
+	void stop(fragment& f);
+
     private:
+	/**
+	 * A streambuf which collects text until it's time to indent
+	 * and escape it.
+	 */
+	class Text : public std::streambuf {
+	public:
+	    std::string s;
+	protected:
+	    int_type overflow(int_type c) override;
+	    std::streamsize xsputn(const char* p, std::streamsize n) override;
+	};
+
 	ostream& text();
 
-	void nl_indent() const;
+	void nl_indent();
 	void flush_indent();
+	void spill();
 
-	std::stack<elem> stack;
-	std::ostringstream ss;
+	std::vector<const char*> stack;
+	Text pending;
+	std::ostream ss;
+	std::string buf;
+	size_t recording = std::string::npos;
 	std::ostream& os;
 	const unsigned indent;
 	char prev;